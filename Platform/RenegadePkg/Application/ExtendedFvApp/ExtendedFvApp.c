@@ -0,0 +1,80 @@
+/** @file
+  Dispatch the extended FV, connect every device and boot the option whose
+  number is passed in the load options.
+
+  PlatformBootManagerLib binds the boot menu hotkey to a hidden boot option
+  for this application, which sits in the core FV. BDS boots hotkey options
+  at TPL_APPLICATION, so the extended FV drivers start at the TPL they
+  expect, before the boot menu that needs them.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DxeServicesTableLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <Protocol/LoadedImage.h>
+
+EFI_STATUS
+EFIAPI
+ExtendedFvAppEntryPoint(
+    IN EFI_HANDLE ImageHandle, IN EFI_SYSTEM_TABLE *SystemTable)
+{
+  EFI_STATUS                   Status;
+  EFI_LOADED_IMAGE_PROTOCOL *  LoadedImage;
+  EFI_HANDLE                   Handle;
+  VOID *                       Interface;
+  UINT16                       OptionNumber;
+  CHAR16                       OptionName[sizeof("Boot####")];
+  EFI_BOOT_MANAGER_LOAD_OPTION Option;
+
+  Status = gBS->HandleProtocol(
+      ImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
+  ASSERT_EFI_ERROR(Status);
+
+  if (LoadedImage->LoadOptionsSize != sizeof(OptionNumber)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  CopyMem(&OptionNumber, LoadedImage->LoadOptions, sizeof(OptionNumber));
+
+  //
+  // Same as PlatformBootManagerLib: the FV_IMAGE file holding the extended
+  // FV depends on the protocol
+  //
+  Status = gBS->LocateProtocol(
+      &gExtendedFvDispatchProtocolGuid, NULL, (VOID **)&Interface);
+  if (EFI_ERROR(Status)) {
+    Handle = NULL;
+    Status = gBS->InstallMultipleProtocolInterfaces(
+        &Handle, &gExtendedFvDispatchProtocolGuid, NULL, NULL);
+    ASSERT_EFI_ERROR(Status);
+
+    Status = gDS->Dispatch();
+    DEBUG((EFI_D_INFO, "%a: Dispatch: %r\n", __FUNCTION__, Status));
+  }
+
+  //
+  // The boot menu lists every device, including the USB ones that only
+  // showed up now
+  //
+  EfiBootManagerConnectAll();
+  EfiBootManagerRefreshAllBootOption();
+
+  UnicodeSPrint(OptionName, sizeof(OptionName), L"Boot%04x", OptionNumber);
+  Status = EfiBootManagerVariableToLoadOption(OptionName, &Option);
+  if (EFI_ERROR(Status)) {
+    DEBUG((EFI_D_ERROR, "%a: %s: %r\n", __FUNCTION__, OptionName, Status));
+    return Status;
+  }
+
+  EfiBootManagerBoot(&Option);
+  Status = Option.Status;
+  EfiBootManagerFreeLoadOption(&Option);
+  return Status;
+}
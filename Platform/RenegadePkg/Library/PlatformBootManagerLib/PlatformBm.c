@@ -11,14 +11,19 @@
 **/
 
 #include <Guid/EventGroup.h>
+#include <Guid/GlobalVariable.h>
 #include <Guid/SerialPortLibVendor.h>
 #include <Guid/TtyTerm.h>
 #include <IndustryStandard/Pci22.h>
 #include <Library/BootLogoLib.h>
 #include <Library/CapsuleLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/DxeServicesTableLib.h>
 #include <Library/HobLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootManagerLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -27,11 +32,13 @@
 
 #include <Protocol/DevicePath.h>
 #include <Protocol/EsrtManagement.h>
+#include <Protocol/FirmwareVolume2.h>
 #include <Protocol/GraphicsOutput.h>
 #include <Protocol/LoadedImage.h>
 #include <Protocol/PciIo.h>
 #include <Protocol/PciRootBridgeIo.h>
 #include <Protocol/PlatformBootManager.h>
+#include <Protocol/SimpleTextInEx.h>
 
 #include "PlatformBm.h"
 
@@ -112,6 +119,67 @@ STATIC PLATFORM_USB_KEYBOARD mUsbKeyboard = {
     {END_DEVICE_PATH_TYPE, END_ENTIRE_DEVICE_PATH_SUBTYPE,
      DP_NODE_LEN(EFI_DEVICE_PATH_PROTOCOL)}};
 
+#pragma pack(1)
+typedef struct {
+  MEDIA_FW_VOL_DEVICE_PATH FvNode;
+  EFI_DEVICE_PATH_PROTOCOL End;
+} PLATFORM_FV_DEVICE_PATH;
+#pragma pack()
+
+//
+// The extended FV has no handle until it is dispatched, so boot options for
+// the applications in it name the FV by its FvNameGuid.
+//
+STATIC PLATFORM_FV_DEVICE_PATH mExtendedFv = {
+    //
+    // MEDIA_FW_VOL_DEVICE_PATH FvNode
+    //
+    {
+        {MEDIA_DEVICE_PATH, MEDIA_PIWG_FW_VOL_DP,
+         DP_NODE_LEN(MEDIA_FW_VOL_DEVICE_PATH)}
+        //
+        // Guid to be filled in dynamically
+        //
+    },
+
+    //
+    // EFI_DEVICE_PATH_PROTOCOL End
+    //
+    {END_DEVICE_PATH_TYPE, END_ENTIRE_DEVICE_PATH_SUBTYPE,
+     DP_NODE_LEN(EFI_DEVICE_PATH_PROTOCOL)}};
+
+//
+// BOOT_WITH_MINIMAL_CONFIGURATION until the extended FV is dispatched, which
+// brings in the boot menu and USB
+//
+STATIC EFI_BOOT_MODE mBootMode = BOOT_WITH_MINIMAL_CONFIGURATION;
+
+//
+// BDS connects the consoles and what the boot options name, everything only
+// for the boot menu or once that was not enough to boot
+//
+STATIC BOOLEAN mConnectedAll;
+
+//
+// The FV application boot options are registered, so a refresh can save the
+// boot device fingerprint right away
+//
+STATIC BOOLEAN mFvOptionsRegistered;
+
+//
+// Connections made by the helpers below, reported at ExitBootServices. Their
+// time is in the PERF log.
+//
+STATIC UINTN mConnectCalls;
+
+//
+// UP or ESC was held when BDS started, so AfterConsole boots the boot menu
+// once everything is connected. BootNext is not used for this: it is a
+// non-volatile variable and would cost a flash write on every menu boot.
+//
+STATIC BOOLEAN mMenuRequested;
+STATIC UINT16  mMenuOption;
+
 /**
   Check if the handle satisfies a particular condition.
 
@@ -237,6 +305,7 @@ VOID EFIAPI Connect(IN EFI_HANDLE Handle, IN CONST CHAR16 *ReportText)
 {
   EFI_STATUS Status;
 
+  mConnectCalls++;
   Status = gBS->ConnectController(
       Handle, // ControllerHandle
       NULL,   // DriverImageHandle
@@ -287,10 +356,129 @@ VOID EFIAPI AddOutput(IN EFI_HANDLE Handle, IN CONST CHAR16 *ReportText)
        ReportText));
 }
 
+/**
+  Check whether the FvFile node at the end of a device path names a file that
+  an installed firmware volume actually holds.
+
+  @param[in] DevicePath  Device path ending in an FvFile node.
+  @param[in] FileGuid    FFS file name in the FvFile node.
+
+  @retval TRUE   The FV is installed and holds the file.
+  @retval FALSE  Otherwise.
+**/
+STATIC
+BOOLEAN
+PlatformFvFileResolves(
+    IN EFI_DEVICE_PATH_PROTOCOL *DevicePath, IN CONST EFI_GUID *FileGuid)
+{
+  EFI_STATUS                     Status;
+  EFI_HANDLE                     FvHandle;
+  EFI_FIRMWARE_VOLUME2_PROTOCOL *Fv;
+  EFI_FV_FILETYPE                FoundType;
+  EFI_FV_FILE_ATTRIBUTES         FileAttributes;
+  UINT32                         AuthenticationStatus;
+  UINTN                          Size;
+
+  Status = gBS->LocateDevicePath(
+      &gEfiFirmwareVolume2ProtocolGuid, &DevicePath, &FvHandle);
+  if (EFI_ERROR(Status)) {
+    return FALSE;
+  }
+
+  Status = gBS->HandleProtocol(
+      FvHandle, &gEfiFirmwareVolume2ProtocolGuid, (VOID **)&Fv);
+  if (EFI_ERROR(Status)) {
+    return FALSE;
+  }
+
+  Status = Fv->ReadFile(
+      Fv, FileGuid, NULL, &Size, &FoundType, &FileAttributes,
+      &AuthenticationStatus);
+  return !EFI_ERROR(Status);
+}
+
+/**
+  Delete the boot options that launch an FV application from a location it is
+  no longer in, such as the core FV the UEFI Shell and SimpleInit were built
+  into before they moved to the extended FV, or with other optional data.
+  Left in place, such an option fails to boot or boots the wrong thing.
+
+  @param[in] FileGuid          FFS file name of the application.
+  @param[in] DevicePath        Device path the application is registered with.
+  @param[in] OptionalData      Optional data it is registered with.
+  @param[in] OptionalDataSize  Size of OptionalData.
+  @param[in] BootOptions       The boot options.
+  @param[in] BootOptionCount   Number of entries in BootOptions.
+**/
+STATIC
+VOID
+PlatformDeleteStaleFvBootOptions(
+    IN CONST EFI_GUID *FileGuid, IN EFI_DEVICE_PATH_PROTOCOL *DevicePath,
+    IN UINT8 *OptionalData OPTIONAL, IN UINT32 OptionalDataSize,
+    IN EFI_BOOT_MANAGER_LOAD_OPTION *BootOptions, IN UINTN BootOptionCount)
+{
+  EFI_DEVICE_PATH_PROTOCOL *Node;
+  CONST EFI_GUID *          NodeGuid;
+  UINTN                     Index;
+  UINTN                     Size;
+
+  Size = GetDevicePathSize(DevicePath);
+
+  for (Index = 0; Index < BootOptionCount; Index++) {
+    Node = BootOptions[Index].FilePath;
+    if (IsDevicePathEnd(Node)) {
+      continue;
+    }
+    while (!IsDevicePathEnd(NextDevicePathNode(Node))) {
+      Node = NextDevicePathNode(Node);
+    }
+
+    NodeGuid = EfiGetNameGuidFromFwVolDevicePathFile(
+        (MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)Node);
+    if (NodeGuid == NULL || !CompareGuid(NodeGuid, FileGuid)) {
+      continue;
+    }
+
+    if (GetDevicePathSize(BootOptions[Index].FilePath) == Size &&
+        CompareMem(BootOptions[Index].FilePath, DevicePath, Size) == 0) {
+      if (BootOptions[Index].OptionalDataSize == OptionalDataSize &&
+          CompareMem(
+              BootOptions[Index].OptionalData, OptionalData,
+              OptionalDataSize) == 0) {
+        continue;
+      }
+    }
+    else if (PlatformFvFileResolves(BootOptions[Index].FilePath, FileGuid)) {
+      continue;
+    }
+
+    DEBUG(
+        (EFI_D_INFO, "%a: deleting stale Boot%04x \"%s\"\n", __FUNCTION__,
+         BootOptions[Index].OptionNumber, BootOptions[Index].Description));
+    EfiBootManagerDeleteLoadOptionVariable(
+        BootOptions[Index].OptionNumber, LoadOptionTypeBoot);
+  }
+}
+
+/**
+  Register a boot option for an application in a firmware volume.
+
+  @param[in] FvDevicePath      Device path of the FV holding the application,
+                               or NULL for the FV this driver was loaded from.
+  @param[in] FileGuid          FFS file name of the application.
+  @param[in] Description       Description of the boot option.
+  @param[in] Attributes        LOAD_OPTION_* attributes of the boot option.
+  @param[in] OptionalData      Load options passed to the application.
+  @param[in] OptionalDataSize  Size of OptionalData.
+
+  @return The option number of the new or already registered boot option.
+**/
 STATIC
 UINT16
 PlatformRegisterFvBootOption(
-    CONST EFI_GUID *FileGuid, CHAR16 *Description, UINT32 Attributes)
+    IN EFI_DEVICE_PATH_PROTOCOL *FvDevicePath OPTIONAL,
+    IN CONST EFI_GUID *FileGuid, IN CHAR16 *Description, IN UINT32 Attributes,
+    IN UINT8 *OptionalData OPTIONAL, IN UINT32 OptionalDataSize)
 {
   EFI_STATUS                        Status;
   INTN                              OptionIndex;
@@ -302,12 +490,16 @@ PlatformRegisterFvBootOption(
   EFI_DEVICE_PATH_PROTOCOL *        DevicePath;
   UINT16                            OptionNumber;
 
-  Status = gBS->HandleProtocol(
-      gImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
-  ASSERT_EFI_ERROR(Status);
+  if (FvDevicePath == NULL) {
+    Status = gBS->HandleProtocol(
+        gImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
+    ASSERT_EFI_ERROR(Status);
+
+    FvDevicePath = DevicePathFromHandle(LoadedImage->DeviceHandle);
+  }
 
   EfiInitializeFwVolDevicepathNode(&FileNode, FileGuid);
-  DevicePath = DevicePathFromHandle(LoadedImage->DeviceHandle);
+  DevicePath = FvDevicePath;
   ASSERT(DevicePath != NULL);
   DevicePath =
       AppendDevicePathNode(DevicePath, (EFI_DEVICE_PATH_PROTOCOL *)&FileNode);
@@ -315,21 +507,28 @@ PlatformRegisterFvBootOption(
 
   Status = EfiBootManagerInitializeLoadOption(
       &NewOption, LoadOptionNumberUnassigned, LoadOptionTypeBoot, Attributes,
-      Description, DevicePath, NULL, 0);
+      Description, DevicePath, OptionalData, OptionalDataSize);
   ASSERT_EFI_ERROR(Status);
-  FreePool(DevicePath);
 
   BootOptions =
       EfiBootManagerGetLoadOptions(&BootOptionCount, LoadOptionTypeBoot);
 
+  PlatformDeleteStaleFvBootOptions(
+      FileGuid, DevicePath, OptionalData, OptionalDataSize, BootOptions,
+      BootOptionCount);
+  FreePool(DevicePath);
+
   OptionIndex =
       EfiBootManagerFindLoadOption(&NewOption, BootOptions, BootOptionCount);
 
   if (OptionIndex == -1) {
     Status = EfiBootManagerAddLoadOptionVariable(&NewOption, MAX_UINTN);
     ASSERT_EFI_ERROR(Status);
+    OptionNumber = NewOption.OptionNumber;
+  }
+  else {
+    OptionNumber = BootOptions[OptionIndex].OptionNumber;
   }
-  OptionNumber = NewOption.OptionNumber;
   EfiBootManagerFreeLoadOption(&NewOption);
   EfiBootManagerFreeLoadOptions(BootOptions, BootOptionCount);
   return OptionNumber;
@@ -420,14 +619,72 @@ VOID GetPlatformOptions(VOID)
   FreePool(BootKeys);
 }
 
+/**
+  Bind a single key to a boot option, replacing whatever option it launched
+  before. Nothing is written if the key is bound to the option already and
+  the CRC BDS checks the option against still matches.
+
+  @param[in] Key           The key.
+  @param[in] OptionNumber  Number of the boot option it launches.
+**/
 STATIC
-VOID PlatformRegisterOptionsAndKeys(VOID)
+VOID PlatformBindKey(IN EFI_INPUT_KEY *Key, IN UINT16 OptionNumber)
+{
+  EFI_STATUS                   Status;
+  EFI_BOOT_MANAGER_KEY_OPTION *KeyOptions;
+  UINTN                        KeyOptionCount;
+  UINTN                        Index;
+  CHAR16                       OptionName[sizeof("Boot####")];
+  VOID *                       Option;
+  UINTN                        OptionSize;
+  UINT32                       Crc;
+
+  Crc = 0;
+  UnicodeSPrint(OptionName, sizeof(OptionName), L"Boot%04x", OptionNumber);
+  GetEfiGlobalVariable2(OptionName, &Option, &OptionSize);
+  if (Option != NULL) {
+    gBS->CalculateCrc32(Option, OptionSize, &Crc);
+    FreePool(Option);
+  }
+
+  KeyOptions = EfiBootManagerGetKeyOptions(&KeyOptionCount);
+  for (Index = 0; Index < KeyOptionCount; Index++) {
+    if (KeyOptions[Index].KeyData.Options.InputKeyCount != 1 ||
+        KeyOptions[Index].Keys[0].ScanCode != Key->ScanCode ||
+        KeyOptions[Index].Keys[0].UnicodeChar != Key->UnicodeChar) {
+      continue;
+    }
+
+    if (KeyOptions[Index].BootOption == OptionNumber &&
+        KeyOptions[Index].BootOptionCrc == Crc) {
+      EfiBootManagerFreeKeyOptions(KeyOptions, KeyOptionCount);
+      return;
+    }
+
+    EfiBootManagerDeleteKeyOptionVariable(NULL, 0, Key, NULL);
+    break;
+  }
+  EfiBootManagerFreeKeyOptions(KeyOptions, KeyOptionCount);
+
+  Status = EfiBootManagerAddKeyOptionVariable(NULL, OptionNumber, 0, Key, NULL);
+  ASSERT(Status == EFI_SUCCESS || Status == EFI_ALREADY_STARTED);
+}
+
+/**
+  Register the platform boot options and hotkeys.
+
+  @return The option number of the boot menu, Simple Init or the Boot
+          Manager Menu.
+**/
+STATIC
+UINT16 PlatformRegisterOptionsAndKeys(VOID)
 {
   EFI_STATUS                   Status;
   EFI_INPUT_KEY                Enter;
   EFI_INPUT_KEY                UP;
-  EFI_INPUT_KEY                Esc;
   EFI_BOOT_MANAGER_LOAD_OPTION BootOption;
+  UINT16                       MenuOption;
+  UINT16                       MenuKeyOption;
 
   GetPlatformOptions();
 
@@ -439,29 +696,313 @@ VOID PlatformRegisterOptionsAndKeys(VOID)
   Status            = EfiBootManagerRegisterContinueKeyOption(0, &Enter, NULL);
   ASSERT_EFI_ERROR(Status);
 
-  //
-  // Map UP and ESC to Boot Manager Menu or SimpleInitGUI
-  //
-  UP.ScanCode     = SCAN_UP;
-  UP.UnicodeChar  = CHAR_NULL;
-  Esc.ScanCode    = SCAN_ESC;
-  Esc.UnicodeChar = CHAR_NULL;
-  Status          = EfiBootManagerGetBootManagerMenu(&BootOption);
+  Status = EfiBootManagerGetBootManagerMenu(&BootOption);
   ASSERT_EFI_ERROR(Status);
 #ifdef ENABLE_SIMPLE_INIT
 
   //
   // Register Simple Init GUI APP
   //
-  UINT16 OptionSimpleInit = PlatformRegisterFvBootOption(
-      &gSimpleInitFileGuid, L"Simple Init", LOAD_OPTION_ACTIVE);
-  Status = EfiBootManagerAddKeyOptionVariable(
-      NULL, (UINT16)OptionSimpleInit, 0, &UP, NULL);
+  MenuOption = PlatformRegisterFvBootOption(
+      (EFI_DEVICE_PATH_PROTOCOL *)&mExtendedFv, &gSimpleInitFileGuid,
+      L"Simple Init", LOAD_OPTION_ACTIVE, NULL, 0);
 #else
-  Status = EfiBootManagerAddKeyOptionVariable(
-      NULL, (UINT16)BootOption.OptionNumber, 0, &UP, NULL);
+  MenuOption = (UINT16)BootOption.OptionNumber;
 #endif
-  ASSERT(Status == EFI_SUCCESS || Status == EFI_ALREADY_STARTED);
+  EfiBootManagerFreeLoadOption(&BootOption);
+
+  //
+  // Map UP to the boot menu through ExtendedFvApp in the core FV, which
+  // dispatches the extended FV at TPL_APPLICATION before it boots the menu.
+  // The option is hidden and not in the boot category, so BDS never boots
+  // it from BootOrder and the menus do not list it.
+  //
+  MenuKeyOption = PlatformRegisterFvBootOption(
+      NULL, &gExtendedFvAppFileGuid, L"Boot Menu",
+      LOAD_OPTION_ACTIVE | LOAD_OPTION_HIDDEN | LOAD_OPTION_CATEGORY_APP,
+      (UINT8 *)&MenuOption, sizeof(MenuOption));
+
+  UP.ScanCode    = SCAN_UP;
+  UP.UnicodeChar = CHAR_NULL;
+  PlatformBindKey(&UP, MenuKeyOption);
+
+  return MenuOption;
+}
+
+/**
+  Release the extended FV and dispatch the drivers in it.
+
+  The FV_IMAGE file holding the extended FV depends on
+  gExtendedFvDispatchProtocolGuid, so DxeCore leaves it compressed until the
+  protocol shows up. Once it is installed, Dispatch() decompresses the FV,
+  publishes it and starts its drivers; applications in it become loadable.
+**/
+STATIC
+VOID PlatformDispatchExtendedFv(VOID)
+{
+  EFI_STATUS Status;
+  EFI_HANDLE Handle;
+  VOID *     Interface;
+
+  Status = gBS->LocateProtocol(
+      &gExtendedFvDispatchProtocolGuid, NULL, (VOID **)&Interface);
+  if (!EFI_ERROR(Status)) {
+    return;
+  }
+
+  Handle = NULL;
+  Status = gBS->InstallMultipleProtocolInterfaces(
+      &Handle, &gExtendedFvDispatchProtocolGuid, NULL, NULL);
+  ASSERT_EFI_ERROR(Status);
+
+  PERF_INMODULE_BEGIN("DispatchExtendedFv");
+  Status = gDS->Dispatch();
+  PERF_INMODULE_END("DispatchExtendedFv");
+
+  mBootMode     = BOOT_WITH_FULL_CONFIGURATION;
+  mConnectedAll = FALSE;
+  DEBUG((EFI_D_INFO, "%a: %r\n", __FUNCTION__, Status));
+}
+
+/**
+  Connect everything and rescan for boot options, which only finds the
+  devices that are connected. Used for the boot menu and when the targeted
+  connection was not enough.
+**/
+STATIC
+VOID PlatformConnectAll(VOID)
+{
+  if (mConnectedAll) {
+    return;
+  }
+
+  mConnectCalls++;
+  PERF_INMODULE_BEGIN("ConnectAll");
+  EfiBootManagerConnectAll();
+  PERF_INMODULE_END("ConnectAll");
+
+  PlatformRefreshAllBootOption();
+  if (mFvOptionsRegistered) {
+    PlatformSaveBootDeviceFingerprint();
+  }
+  mConnectedAll = TRUE;
+}
+
+/**
+  Load the options BDS is going to try, BootNext if it is set and BootOrder
+  otherwise.
+
+  @param[out]  OptionCount  Number of options returned.
+
+  @return The options, to be freed with EfiBootManagerFreeLoadOptions().
+**/
+STATIC
+EFI_BOOT_MANAGER_LOAD_OPTION *PlatformGetBootOptions(OUT UINTN *OptionCount)
+{
+  UINT16 *                      BootNext;
+  CHAR16                        OptionName[sizeof("Boot####")];
+  EFI_BOOT_MANAGER_LOAD_OPTION  Option;
+  EFI_BOOT_MANAGER_LOAD_OPTION *Options;
+
+  GetEfiGlobalVariable2(
+      EFI_BOOT_NEXT_VARIABLE_NAME, (VOID **)&BootNext, NULL);
+
+  if (BootNext != NULL) {
+    UnicodeSPrint(OptionName, sizeof(OptionName), L"Boot%04x", *BootNext);
+    FreePool(BootNext);
+
+    if (!EFI_ERROR(EfiBootManagerVariableToLoadOption(OptionName, &Option))) {
+      Options = AllocateCopyPool(sizeof(Option), &Option);
+      if (Options != NULL) {
+        *OptionCount = 1;
+        return Options;
+      }
+      EfiBootManagerFreeLoadOption(&Option);
+    }
+  }
+
+  return EfiBootManagerGetLoadOptions(OptionCount, LoadOptionTypeBoot);
+}
+
+/**
+  Check whether the option BDS tries first launches an application from the
+  extended FV, or whether the USB policy wants USB for it or for ConIn.
+
+  BDS signals ReadyToBoot at TPL_CALLBACK, too late and at the wrong TPL to
+  dispatch drivers, so this is decided up front. Should BDS fall back to
+  another option that needs the extended FV, that option fails to load and
+  PlatformBootManagerUnableToBoot() starts everything.
+**/
+STATIC
+BOOLEAN PlatformBootNeedsExtendedFv(VOID)
+{
+  EFI_DEVICE_PATH_PROTOCOL *    ConIn;
+  EFI_BOOT_MANAGER_LOAD_OPTION *Options;
+  UINTN                         OptionCount;
+  UINTN                         Index;
+  MEDIA_FW_VOL_DEVICE_PATH *    FvNode;
+  BOOLEAN                       Required;
+
+  GetEfiGlobalVariable2(EFI_CON_IN_VARIABLE_NAME, (VOID **)&ConIn, NULL);
+
+  Options  = PlatformGetBootOptions(&OptionCount);
+  Required = PlatformUsbRequired(
+      Options, OptionCount, ConIn, (EFI_DEVICE_PATH_PROTOCOL *)&mUsbKeyboard);
+
+  for (Index = 0; Index < OptionCount && !Required; Index++) {
+    if ((Options[Index].Attributes & LOAD_OPTION_ACTIVE) == 0 ||
+        (Options[Index].Attributes & LOAD_OPTION_CATEGORY) !=
+            LOAD_OPTION_CATEGORY_BOOT) {
+      continue;
+    }
+
+    FvNode   = (MEDIA_FW_VOL_DEVICE_PATH *)Options[Index].FilePath;
+    Required = DevicePathType(FvNode) == MEDIA_DEVICE_PATH &&
+               DevicePathSubType(FvNode) == MEDIA_PIWG_FW_VOL_DP &&
+               CompareGuid(&FvNode->FvName, &gExtendedFvNameGuid);
+    break;
+  }
+
+  EfiBootManagerFreeLoadOptions(Options, OptionCount);
+
+  if (ConIn != NULL) {
+    FreePool(ConIn);
+  }
+
+  return Required;
+}
+
+/**
+  Connect the device paths of the options BDS is going to try. The consoles
+  are connected by BDS already. Short-form paths do not connect here, BDS
+  expands those itself and connects everything when its cache misses.
+
+  @return The number of active boot options that name a device rather than
+          an application in a firmware volume.
+**/
+STATIC
+UINTN PlatformConnectBootOptions(VOID)
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION *Options;
+  UINTN                         OptionCount;
+  UINTN                         Index;
+  UINTN                         Named;
+  EFI_DEVICE_PATH_PROTOCOL *    FilePath;
+
+  PERF_INMODULE_BEGIN("ConnectBootOptions");
+
+  Options = PlatformGetBootOptions(&OptionCount);
+  Named   = 0;
+  for (Index = 0; Index < OptionCount; Index++) {
+    FilePath = Options[Index].FilePath;
+    if ((Options[Index].Attributes & LOAD_OPTION_ACTIVE) == 0 ||
+        (Options[Index].Attributes & LOAD_OPTION_CATEGORY) !=
+            LOAD_OPTION_CATEGORY_BOOT ||
+        (DevicePathType(FilePath) == MEDIA_DEVICE_PATH &&
+         DevicePathSubType(FilePath) == MEDIA_PIWG_FW_VOL_DP)) {
+      continue;
+    }
+
+    Named++;
+    mConnectCalls++;
+    EfiBootManagerConnectDevicePath(FilePath, NULL);
+  }
+
+  EfiBootManagerFreeLoadOptions(Options, OptionCount);
+
+  PERF_INMODULE_END("ConnectBootOptions");
+  return Named;
+}
+
+/**
+  Check whether the boot menu key, UP or ESC, is held down while BDS starts,
+  on any input device that is already up. The keypad is, even before the
+  consoles are connected. The keys read are consumed.
+**/
+STATIC
+BOOLEAN PlatformKeyHeld(VOID)
+{
+  EFI_STATUS                         Status;
+  EFI_HANDLE *                       Handles;
+  UINTN                              HandleCount;
+  UINTN                              Index;
+  EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL *TextInEx;
+  EFI_KEY_DATA                       KeyData;
+  BOOLEAN                            Held;
+
+  Status = gBS->LocateHandleBuffer(
+      ByProtocol, &gEfiSimpleTextInputExProtocolGuid, NULL, &HandleCount,
+      &Handles);
+  if (EFI_ERROR(Status)) {
+    return FALSE;
+  }
+
+  Held = FALSE;
+  for (Index = 0; Index < HandleCount && !Held; Index++) {
+    Status = gBS->HandleProtocol(
+        Handles[Index], &gEfiSimpleTextInputExProtocolGuid,
+        (VOID **)&TextInEx);
+    if (EFI_ERROR(Status)) {
+      continue;
+    }
+
+    while (!Held &&
+           !EFI_ERROR(TextInEx->ReadKeyStrokeEx(TextInEx, &KeyData))) {
+      Held = KeyData.Key.ScanCode == SCAN_UP ||
+             KeyData.Key.ScanCode == SCAN_ESC;
+    }
+  }
+
+  FreePool(Handles);
+  return Held;
+}
+
+/**
+  Boot the boot menu for the key held at BDS start. AfterConsole runs at
+  TPL_APPLICATION with every device connected, as the menu expects. When the
+  menu returns, BDS goes on with BootOrder.
+**/
+STATIC
+VOID PlatformBootMenu(VOID)
+{
+  EFI_STATUS                   Status;
+  CHAR16                       OptionName[sizeof("Boot####")];
+  EFI_BOOT_MANAGER_LOAD_OPTION Option;
+
+  UnicodeSPrint(OptionName, sizeof(OptionName), L"Boot%04x", mMenuOption);
+  Status = EfiBootManagerVariableToLoadOption(OptionName, &Option);
+  if (EFI_ERROR(Status)) {
+    DEBUG((EFI_D_ERROR, "%a: %s: %r\n", __FUNCTION__, OptionName, Status));
+    return;
+  }
+
+  EfiBootManagerBoot(&Option);
+  EfiBootManagerFreeLoadOption(&Option);
+}
+
+/**
+  Report how long the boot took in the configuration it ended up in. The
+  generic timer runs from power on, so this includes the bootloader.
+**/
+STATIC
+VOID EFIAPI OnExitBootServices(IN EFI_EVENT Event, IN VOID *Context)
+{
+  EFI_STATUS Status;
+  VOID *     Interface;
+
+  //
+  // ExtendedFvApp may have dispatched the extended FV for the boot menu
+  //
+  Status = gBS->LocateProtocol(
+      &gExtendedFvDispatchProtocolGuid, NULL, (VOID **)&Interface);
+
+  DEBUG(
+      (EFI_D_INFO, "PlatformBm: %a configuration, ExitBootServices at %lu ms\n",
+       EFI_ERROR(Status) ? "minimal" : "full",
+       DivU64x32(GetTimeInNanoSecond(GetPerformanceCounter()), 1000000)));
+  DEBUG(
+      (EFI_D_INFO, "PlatformBm: %lu connections%a\n", (UINT64)mConnectCalls,
+       mConnectedAll ? ", connected all" : ""));
 }
 
 //
@@ -480,11 +1021,25 @@ VOID PlatformRegisterOptionsAndKeys(VOID)
 **/
 VOID EFIAPI PlatformBootManagerBeforeConsole(VOID)
 {
+  EFI_STATUS Status;
+  EFI_EVENT  ExitBootServicesEvent;
+
   //
   // Signal EndOfDxe PI Event
   //
   EfiEventGroupSignal(&gEfiEndOfDxeEventGroupGuid);
 
+  //
+  // The extended FV stays compressed unless the option being booted needs
+  // an application from it.
+  //
+  CopyGuid(&mExtendedFv.FvNode.FvName, &gExtendedFvNameGuid);
+
+  Status = gBS->CreateEventEx(
+      EVT_NOTIFY_SIGNAL, TPL_CALLBACK, OnExitBootServices, NULL,
+      &gEfiEventExitBootServicesGuid, &ExitBootServicesEvent);
+  ASSERT_EFI_ERROR(Status);
+
   //
   // Dispatch deferred images after EndOfDxe event.
   //
@@ -495,6 +1050,7 @@ VOID EFIAPI PlatformBootManagerBeforeConsole(VOID)
   // non-recursively. This will produce a number of child handles with PciIo on
   // them.
   //
+  PERF_INMODULE_BEGIN("ConnectPci");
   FilterAndProcess(&gEfiPciRootBridgeIoProtocolGuid, NULL, Connect);
 
   //
@@ -503,6 +1059,7 @@ VOID EFIAPI PlatformBootManagerBeforeConsole(VOID)
   // child handles with GOPs on them.
   //
   FilterAndProcess(&gEfiPciIoProtocolGuid, IsPciDisplay, Connect);
+  PERF_INMODULE_END("ConnectPci");
 
   //
   // Now add the device path of all handles with GOP on them to ConOut and
@@ -548,7 +1105,27 @@ VOID EFIAPI PlatformBootManagerBeforeConsole(VOID)
   //
   // Register platform-specific boot options and keyboard shortcuts.
   //
-  PlatformRegisterOptionsAndKeys();
+  mMenuOption = PlatformRegisterOptionsAndKeys();
+
+  //
+  // Boot the default option in the minimal configuration unless the boot
+  // menu key is held. Then dispatch the boot menu and USB drivers before the
+  // consoles come up, and let AfterConsole enter the menu, since the key is
+  // used up.
+  //
+  if (PlatformKeyHeld()) {
+    DEBUG((EFI_D_INFO, "%a: key held, full configuration\n", __FUNCTION__));
+    PlatformDispatchExtendedFv();
+    mMenuRequested = TRUE;
+  }
+  else if (PlatformBootNeedsExtendedFv()) {
+    //
+    // Start USB before the consoles are connected and AfterConsole connects
+    // the rest
+    //
+    DEBUG((EFI_D_INFO, "%a: boot needs the extended FV\n", __FUNCTION__));
+    PlatformDispatchExtendedFv();
+  }
 }
 
 STATIC
@@ -654,9 +1231,13 @@ VOID EFIAPI PlatformBootManagerAfterConsole(VOID)
   }
 
   //
-  // Connect the rest of the devices.
+  // Connect only what the boot options name. The boot menu needs every
+  // device, and so does a first boot that has no options yet.
   //
-  EfiBootManagerConnectAll();
+  if (mBootMode != BOOT_WITH_MINIMAL_CONFIGURATION ||
+      PlatformConnectBootOptions() == 0) {
+    PlatformConnectAll();
+  }
 
   //
   // On ARM, there is currently no reason to use the phased capsule
@@ -667,23 +1248,20 @@ VOID EFIAPI PlatformBootManagerAfterConsole(VOID)
   //
   HandleCapsules();
 
-  //
-  // Enumerate all possible boot options.
-  //
-  EfiBootManagerRefreshAllBootOption();
-
   //
   // Register UEFI Shell
   //
   PlatformRegisterFvBootOption(
-      &gUefiShellFileGuid, L"UEFI Shell", LOAD_OPTION_ACTIVE);
+      (EFI_DEVICE_PATH_PROTOCOL *)&mExtendedFv, &gUefiShellFileGuid,
+      L"UEFI Shell", LOAD_OPTION_ACTIVE, NULL, 0);
 
 #ifdef ENABLE_LINUX_SIMPLE_MASS_STORAGE
   //
   // Register Built-in Linux Kernel
   //
   PlatformRegisterFvBootOption(
-      &gLinuxSimpleMassStorageGuid, L"USB Attached SCSI (UAS) Storage", LOAD_OPTION_ACTIVE);
+      (EFI_DEVICE_PATH_PROTOCOL *)&mExtendedFv, &gLinuxSimpleMassStorageGuid,
+      L"USB Attached SCSI (UAS) Storage", LOAD_OPTION_ACTIVE, NULL, 0);
 #endif
 
 #ifdef AB_SLOTS_SUPPORT
@@ -691,10 +1269,31 @@ VOID EFIAPI PlatformBootManagerAfterConsole(VOID)
   // Register Switch Slots App
   //
   PlatformRegisterFvBootOption(
-      &gSwitchSlotsAppFileGuid, L"Reboot to other slot", LOAD_OPTION_ACTIVE);
+      (EFI_DEVICE_PATH_PROTOCOL *)&mExtendedFv, &gSwitchSlotsAppFileGuid,
+      L"Reboot to other slot", LOAD_OPTION_ACTIVE, NULL, 0);
 #endif
 
+  //
+  // The fingerprint covers the options registered above
+  //
+  mFvOptionsRegistered = TRUE;
+  PlatformSaveBootDeviceFingerprint();
+
+  //
+  // A first boot has no other options yet, so one of the applications
+  // registered above may now be the one BDS tries first
+  //
+  if (mBootMode == BOOT_WITH_MINIMAL_CONFIGURATION &&
+      PlatformBootNeedsExtendedFv()) {
+    PlatformDispatchExtendedFv();
+    PlatformConnectAll();
+  }
+
   PlatformSetup();
+
+  if (mMenuRequested) {
+    PlatformBootMenu();
+  }
 }
 
 /**
@@ -741,4 +1340,12 @@ VOID EFIAPI PlatformBootManagerWaitCallback(UINT16 TimeoutRemain)
 
   If this function returns, BDS attempts to enter an infinite loop.
 **/
-VOID EFIAPI PlatformBootManagerUnableToBoot(VOID) { return; }
+VOID EFIAPI PlatformBootManagerUnableToBoot(VOID)
+{
+  //
+  // BDS falls back to the boot menu, which needs the browser drivers and
+  // every device
+  //
+  PlatformDispatchExtendedFv();
+  PlatformConnectAll();
+}
@@ -24,6 +24,7 @@
 #include <Library/DebugLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootManagerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -53,4 +54,55 @@ EnableQuietBoot(IN EFI_GUID *LogoFile);
 EFI_STATUS
 DisableQuietBoot(VOID);
 
+/**
+  Check whether a device path goes through USB.
+
+  @param[in]  DevicePath  Device path to check, may have several instances.
+  @param[in]  Ignore      Single instance device path that does not count.
+
+  @retval TRUE   An instance other than Ignore has a USB node.
+  @retval FALSE  No such instance, or DevicePath is NULL or malformed.
+**/
+BOOLEAN
+PlatformDevicePathHasUsb(
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *DevicePath,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *Ignore OPTIONAL);
+
+/**
+  The USB policy: decide whether a boot needs the USB stack started.
+
+  @param[in]  Options       Boot options in the order BDS tries them.
+  @param[in]  OptionCount   Number of entries in Options.
+  @param[in]  ConIn         The ConIn variable.
+  @param[in]  DefaultConIn  The USB keyboard the platform always adds to
+                            ConIn, which is used when USB is up but does
+                            not require it.
+
+  @retval TRUE   ConIn has another USB device, or the first active boot
+                 option is on USB.
+  @retval FALSE  The boot can go ahead without USB.
+**/
+BOOLEAN
+PlatformUsbRequired(
+    IN CONST EFI_BOOT_MANAGER_LOAD_OPTION *Options,
+    IN UINTN                               OptionCount,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *    ConIn OPTIONAL,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *    DefaultConIn OPTIONAL);
+
+/**
+  EfiBootManagerRefreshAllBootOption(), unless the connected boot devices
+  and the FV application boot options are the same as after the last
+  refresh.
+**/
+VOID
+PlatformRefreshAllBootOption(VOID);
+
+/**
+  Save the fingerprint PlatformRefreshAllBootOption() compares against, if
+  the boot options were refreshed since it was last saved. Called once the
+  FV application boot options are registered.
+**/
+VOID
+PlatformSaveBootDeviceFingerprint(VOID);
+
 #endif // _PLATFORM_BM_H_
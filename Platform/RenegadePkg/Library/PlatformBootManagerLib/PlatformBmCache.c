@@ -0,0 +1,240 @@
+/** @file
+  Skips the boot option refresh when the boot devices have not changed.
+
+  EfiBootManagerRefreshAllBootOption goes through every block, file system
+  and load file handle and writes the Boot#### variables it changes. The
+  fingerprint below covers what that depends on: the device paths of those
+  handles, the size of each disk and the CRCs in its GPT header. It also
+  covers the boot options for the FV applications the platform registers, so
+  it is saved once those are registered, after the refresh. It is kept in an
+  NV variable and the refresh only runs when it changes.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi/UefiGpt.h>
+
+#include <Library/PerformanceLib.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Protocol/BlockIo.h>
+#include <Protocol/LoadFile.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#include "PlatformBm.h"
+
+#define BOOT_DEVICE_FINGERPRINT_NAME L"BootDeviceFingerprint"
+
+//
+// What the fingerprint takes from a whole disk, partitions are covered by
+// their device paths
+//
+typedef struct {
+  EFI_LBA LastBlock;
+  UINT32  BlockSize;
+  UINT32  HeaderCrc;
+  UINT32  EntryArrayCrc;
+} BOOT_DEVICE_DISK;
+
+//
+// Set when the boot options were refreshed and the fingerprint is not saved
+// yet
+//
+STATIC BOOLEAN mFingerprintPending;
+
+STATIC
+VOID FingerprintAdd(IN OUT UINT32 *Fingerprint, IN VOID *Data, IN UINTN Length)
+{
+  UINT32 Crc[2];
+
+  Crc[0]       = *Fingerprint;
+  Crc[1]       = CalculateCrc32(Data, Length);
+  *Fingerprint = CalculateCrc32(Crc, sizeof(Crc));
+}
+
+STATIC
+VOID FingerprintAddDisk(
+    IN OUT UINT32 *Fingerprint, IN EFI_BLOCK_IO_PROTOCOL *BlockIo)
+{
+  EFI_STATUS                  Status;
+  BOOT_DEVICE_DISK            Disk;
+  EFI_PARTITION_TABLE_HEADER *Header;
+  UINTN                       Pages;
+
+  if (BlockIo->Media->LogicalPartition) {
+    return;
+  }
+
+  ZeroMem(&Disk, sizeof(Disk));
+  if (BlockIo->Media->MediaPresent) {
+    Disk.LastBlock = BlockIo->Media->LastBlock;
+    Disk.BlockSize = BlockIo->Media->BlockSize;
+  }
+
+  //
+  // The primary GPT header sits in LBA 1, page alignment covers any IoAlign
+  // the UFS and SD drivers ask for
+  //
+  Pages  = EFI_SIZE_TO_PAGES(Disk.BlockSize);
+  Header = NULL;
+  if (Disk.BlockSize >= sizeof(*Header)) {
+    Header = AllocatePages(Pages);
+  }
+
+  if (Header != NULL) {
+    Status = BlockIo->ReadBlocks(
+        BlockIo, BlockIo->Media->MediaId, PRIMARY_PART_HEADER_LBA,
+        Disk.BlockSize, Header);
+    if (!EFI_ERROR(Status) &&
+        Header->Header.Signature == EFI_PTAB_HEADER_ID) {
+      Disk.HeaderCrc     = Header->Header.CRC32;
+      Disk.EntryArrayCrc = Header->PartitionEntryArrayCRC32;
+    }
+
+    FreePages(Header, Pages);
+  }
+
+  FingerprintAdd(Fingerprint, &Disk, sizeof(Disk));
+}
+
+STATIC
+VOID FingerprintAddHandles(IN OUT UINT32 *Fingerprint, IN EFI_GUID *Protocol)
+{
+  EFI_STATUS                Status;
+  EFI_HANDLE *              Handles;
+  UINTN                     HandleCount;
+  UINTN                     Index;
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  EFI_BLOCK_IO_PROTOCOL *   BlockIo;
+
+  Status = gBS->LocateHandleBuffer(
+      ByProtocol, Protocol, NULL, &HandleCount, &Handles);
+  if (EFI_ERROR(Status)) {
+    return;
+  }
+
+  FingerprintAdd(Fingerprint, &HandleCount, sizeof(HandleCount));
+  for (Index = 0; Index < HandleCount; Index++) {
+    DevicePath = DevicePathFromHandle(Handles[Index]);
+    if (DevicePath != NULL) {
+      FingerprintAdd(Fingerprint, DevicePath, GetDevicePathSize(DevicePath));
+    }
+
+    if (CompareGuid(Protocol, &gEfiBlockIoProtocolGuid)) {
+      Status = gBS->HandleProtocol(
+          Handles[Index], &gEfiBlockIoProtocolGuid, (VOID **)&BlockIo);
+      if (!EFI_ERROR(Status)) {
+        FingerprintAddDisk(Fingerprint, BlockIo);
+      }
+    }
+  }
+
+  FreePool(Handles);
+}
+
+//
+// The boot options that launch an application from a firmware volume: the
+// boot manager menu and the applications PlatformBootManagerLib registers.
+// A firmware update that adds, moves or drops one of them changes these.
+//
+STATIC
+VOID FingerprintAddFvOptions(IN OUT UINT32 *Fingerprint)
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION *BootOptions;
+  UINTN                         BootOptionCount;
+  UINTN                         Index;
+  EFI_DEVICE_PATH_PROTOCOL *    Node;
+
+  BootOptions =
+      EfiBootManagerGetLoadOptions(&BootOptionCount, LoadOptionTypeBoot);
+
+  for (Index = 0; Index < BootOptionCount; Index++) {
+    Node = BootOptions[Index].FilePath;
+    if (IsDevicePathEnd(Node)) {
+      continue;
+    }
+    while (!IsDevicePathEnd(NextDevicePathNode(Node))) {
+      Node = NextDevicePathNode(Node);
+    }
+
+    if (EfiGetNameGuidFromFwVolDevicePathFile(
+            (MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)Node) == NULL) {
+      continue;
+    }
+
+    FingerprintAdd(
+        Fingerprint, &BootOptions[Index].OptionNumber,
+        sizeof(BootOptions[Index].OptionNumber));
+    FingerprintAdd(
+        Fingerprint, &BootOptions[Index].Attributes,
+        sizeof(BootOptions[Index].Attributes));
+    FingerprintAdd(
+        Fingerprint, BootOptions[Index].FilePath,
+        GetDevicePathSize(BootOptions[Index].FilePath));
+  }
+
+  EfiBootManagerFreeLoadOptions(BootOptions, BootOptionCount);
+}
+
+STATIC
+UINT32 BootDeviceFingerprint(VOID)
+{
+  UINT32 Fingerprint;
+
+  Fingerprint = 0;
+  FingerprintAddHandles(&Fingerprint, &gEfiBlockIoProtocolGuid);
+  FingerprintAddHandles(&Fingerprint, &gEfiSimpleFileSystemProtocolGuid);
+  FingerprintAddHandles(&Fingerprint, &gEfiLoadFileProtocolGuid);
+  FingerprintAddFvOptions(&Fingerprint);
+
+  return Fingerprint;
+}
+
+VOID PlatformRefreshAllBootOption(VOID)
+{
+  EFI_STATUS Status;
+  UINT32     Fingerprint;
+  UINT32     Saved;
+  UINTN      Size;
+
+  PERF_INMODULE_BEGIN("RefreshAllBootOption");
+
+  Fingerprint = BootDeviceFingerprint();
+
+  Size   = sizeof(Saved);
+  Status = gRT->GetVariable(
+      BOOT_DEVICE_FINGERPRINT_NAME, &gBootDeviceFingerprintGuid, NULL, &Size,
+      &Saved);
+  if (!EFI_ERROR(Status) && Size == sizeof(Saved) && Saved == Fingerprint) {
+    DEBUG(
+        (EFI_D_INFO, "%a: boot devices unchanged (%08x)\n", __FUNCTION__,
+         Fingerprint));
+    goto Done;
+  }
+
+  EfiBootManagerRefreshAllBootOption();
+  mFingerprintPending = TRUE;
+
+Done:
+  PERF_INMODULE_END("RefreshAllBootOption");
+}
+
+VOID PlatformSaveBootDeviceFingerprint(VOID)
+{
+  EFI_STATUS Status;
+  UINT32     Fingerprint;
+
+  if (!mFingerprintPending) {
+    return;
+  }
+
+  Fingerprint = BootDeviceFingerprint();
+  Status      = gRT->SetVariable(
+      BOOT_DEVICE_FINGERPRINT_NAME, &gBootDeviceFingerprintGuid,
+      EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+      sizeof(Fingerprint), &Fingerprint);
+  DEBUG(
+      (EFI_D_INFO, "%a: refreshed, fingerprint %08x: %r\n", __FUNCTION__,
+       Fingerprint, Status));
+
+  mFingerprintPending = FALSE;
+}
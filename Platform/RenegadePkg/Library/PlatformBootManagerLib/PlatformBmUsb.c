@@ -0,0 +1,102 @@
+/** @file
+  Decides whether a boot needs the USB stack.
+
+  The USB drivers are in the extended FV, which a minimal configuration
+  boot leaves compressed. This file only looks at device paths and load
+  options, so it can be linked into a host test with mock boot options.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Library/UefiBootManagerLib.h>
+
+#include "PlatformBm.h"
+
+STATIC
+BOOLEAN
+IsUsbNode(IN CONST EFI_DEVICE_PATH_PROTOCOL *Node)
+{
+  if (DevicePathType(Node) != MESSAGING_DEVICE_PATH) {
+    return FALSE;
+  }
+
+  switch (DevicePathSubType(Node)) {
+  case MSG_USB_DP:
+  case MSG_USB_CLASS_DP:
+  case MSG_USB_WWID_DP:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+BOOLEAN
+PlatformDevicePathHasUsb(
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *DevicePath,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *Ignore OPTIONAL)
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL *Instance;
+  CONST EFI_DEVICE_PATH_PROTOCOL *Node;
+  UINTN                           IgnoreSize;
+  BOOLEAN                         HasUsb;
+
+  if (DevicePath == NULL || !IsDevicePathValid(DevicePath, 0)) {
+    return FALSE;
+  }
+
+  IgnoreSize = 0;
+  if (Ignore != NULL) {
+    IgnoreSize = GetDevicePathSize(Ignore) - END_DEVICE_PATH_LENGTH;
+  }
+
+  Instance = DevicePath;
+  for (;;) {
+    HasUsb = FALSE;
+    for (Node = Instance; !IsDevicePathEndType(Node);
+         Node = NextDevicePathNode(Node)) {
+      HasUsb |= IsUsbNode(Node);
+    }
+
+    if (HasUsb &&
+        !(Ignore != NULL && (UINTN)Node - (UINTN)Instance == IgnoreSize &&
+          CompareMem(Instance, Ignore, IgnoreSize) == 0)) {
+      return TRUE;
+    }
+
+    if (IsDevicePathEnd(Node)) {
+      return FALSE;
+    }
+
+    Instance = NextDevicePathNode(Node);
+  }
+}
+
+BOOLEAN
+PlatformUsbRequired(
+    IN CONST EFI_BOOT_MANAGER_LOAD_OPTION *Options,
+    IN UINTN                               OptionCount,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *    ConIn OPTIONAL,
+    IN CONST EFI_DEVICE_PATH_PROTOCOL *    DefaultConIn OPTIONAL)
+{
+  UINTN Index;
+
+  if (PlatformDevicePathHasUsb(ConIn, DefaultConIn)) {
+    return TRUE;
+  }
+
+  //
+  // Only the option BDS tries first. A fallback to a USB option fails and
+  // ends in PlatformBootManagerUnableToBoot(), which starts everything.
+  //
+  for (Index = 0; Index < OptionCount; Index++) {
+    if ((Options[Index].Attributes & LOAD_OPTION_ACTIVE) == 0 ||
+        (Options[Index].Attributes & LOAD_OPTION_CATEGORY) !=
+            LOAD_OPTION_CATEGORY_BOOT) {
+      continue;
+    }
+
+    return PlatformDevicePathHasUsb(Options[Index].FilePath, NULL);
+  }
+
+  return FALSE;
+}
@@ -0,0 +1,365 @@
+/** @file
+  Host tests for the PlatformBootManagerLib USB policy.
+
+  PlatformUsbRequired() is given the boot options in the order BDS tries
+  them: BootNext alone when it is set, BootOrder otherwise. The cases below
+  build those lists and ConIn from device paths of the kind this platform
+  produces.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../PlatformBm.h"
+
+#define UNIT_TEST_APP_NAME    "PlatformBootManagerLib USB Policy Host Tests"
+#define UNIT_TEST_APP_VERSION "1.0"
+
+//
+// Device paths, each built once for the whole run
+//
+STATIC EFI_DEVICE_PATH_PROTOCOL *mUfsDisk;
+STATIC EFI_DEVICE_PATH_PROTOCOL *mUsbDisk;
+STATIC EFI_DEVICE_PATH_PROTOCOL *mUsbKeyboard;
+STATIC EFI_DEVICE_PATH_PROTOCOL *mDefaultUsbKeyboard;
+STATIC EFI_DEVICE_PATH_PROTOCOL *mSerial;
+STATIC EFI_DEVICE_PATH_PROTOCOL *mShellApp;
+
+/**
+  Append a node of the given type and length, zero filled apart from the
+  header, to a device path and free the old one.
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL *
+AppendNode(
+    IN EFI_DEVICE_PATH_PROTOCOL *DevicePath OPTIONAL, IN UINT8 Type,
+    IN UINT8 SubType, IN UINT16 Length)
+{
+  EFI_DEVICE_PATH_PROTOCOL *Node;
+  EFI_DEVICE_PATH_PROTOCOL *Result;
+
+  Node = CreateDeviceNode(Type, SubType, Length);
+  ASSERT(Node != NULL);
+  Result = AppendDevicePathNode(DevicePath, Node);
+  ASSERT(Result != NULL);
+  FreePool(Node);
+  if (DevicePath != NULL) {
+    FreePool(DevicePath);
+  }
+  return Result;
+}
+
+/**
+  A USB class node for a HID boot keyboard, as the platform puts in ConIn.
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL *
+CreateDefaultUsbKeyboard(VOID)
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  USB_CLASS_DEVICE_PATH *   Class;
+
+  DevicePath = AppendNode(
+      NULL, MESSAGING_DEVICE_PATH, MSG_USB_CLASS_DP,
+      sizeof(USB_CLASS_DEVICE_PATH));
+  Class                 = (USB_CLASS_DEVICE_PATH *)DevicePath;
+  Class->VendorId       = 0xFFFF;
+  Class->ProductId      = 0xFFFF;
+  Class->DeviceClass    = 3;
+  Class->DeviceSubClass = 1;
+  Class->DeviceProtocol = 1;
+  return DevicePath;
+}
+
+/**
+  Join device path instances into one multi-instance device path.
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL *
+JoinInstances(
+    IN EFI_DEVICE_PATH_PROTOCOL *First, IN EFI_DEVICE_PATH_PROTOCOL *Second)
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  DevicePath = AppendDevicePathInstance(First, Second);
+  ASSERT(DevicePath != NULL);
+  return DevicePath;
+}
+
+STATIC
+VOID
+InitOption(
+    OUT EFI_BOOT_MANAGER_LOAD_OPTION *Option,
+    IN EFI_DEVICE_PATH_PROTOCOL *DevicePath, IN UINT32 Attributes)
+{
+  ZeroMem(Option, sizeof(*Option));
+  Option->OptionType = LoadOptionTypeBoot;
+  Option->Attributes = Attributes;
+  Option->FilePath   = DevicePath;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+DevicePathHasUsb(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_DEVICE_PATH_PROTOCOL *ConIn;
+
+  UT_ASSERT_FALSE(PlatformDevicePathHasUsb(NULL, NULL));
+  UT_ASSERT_FALSE(PlatformDevicePathHasUsb(mUfsDisk, NULL));
+  UT_ASSERT_TRUE(PlatformDevicePathHasUsb(mUsbDisk, NULL));
+  UT_ASSERT_TRUE(PlatformDevicePathHasUsb(mUsbKeyboard, NULL));
+
+  //
+  // The USB instance is the second one
+  //
+  ConIn = JoinInstances(mSerial, mUsbKeyboard);
+  UT_ASSERT_TRUE(PlatformDevicePathHasUsb(ConIn, NULL));
+  FreePool(ConIn);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+DefaultKeyboardIgnored(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_DEVICE_PATH_PROTOCOL *ConIn;
+
+  //
+  // The keyboard the platform always adds does not start USB on its own
+  //
+  ConIn = JoinInstances(mSerial, mDefaultUsbKeyboard);
+  UT_ASSERT_TRUE(PlatformDevicePathHasUsb(ConIn, NULL));
+  UT_ASSERT_FALSE(PlatformDevicePathHasUsb(ConIn, mDefaultUsbKeyboard));
+  UT_ASSERT_FALSE(PlatformUsbRequired(NULL, 0, ConIn, mDefaultUsbKeyboard));
+  FreePool(ConIn);
+
+  //
+  // A keyboard the user picked does
+  //
+  ConIn = JoinInstances(mDefaultUsbKeyboard, mUsbKeyboard);
+  UT_ASSERT_TRUE(PlatformDevicePathHasUsb(ConIn, mDefaultUsbKeyboard));
+  UT_ASSERT_TRUE(PlatformUsbRequired(NULL, 0, ConIn, mDefaultUsbKeyboard));
+  FreePool(ConIn);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BootOrderFirstOptionDecides(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION Options[3];
+
+  //
+  // UFS first: a USB option further down does not start USB
+  //
+  InitOption(&Options[0], mUfsDisk, LOAD_OPTION_ACTIVE);
+  InitOption(&Options[1], mUsbDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_FALSE(PlatformUsbRequired(Options, 2, NULL, mDefaultUsbKeyboard));
+
+  //
+  // USB first
+  //
+  InitOption(&Options[0], mUsbDisk, LOAD_OPTION_ACTIVE);
+  InitOption(&Options[1], mUfsDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_TRUE(PlatformUsbRequired(Options, 2, NULL, mDefaultUsbKeyboard));
+
+  //
+  // Inactive options and applications are skipped
+  //
+  InitOption(&Options[0], mUfsDisk, 0);
+  InitOption(
+      &Options[1], mShellApp, LOAD_OPTION_ACTIVE | LOAD_OPTION_CATEGORY_APP);
+  InitOption(&Options[2], mUsbDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_TRUE(PlatformUsbRequired(Options, 3, NULL, mDefaultUsbKeyboard));
+
+  InitOption(&Options[0], mUsbDisk, 0);
+  InitOption(&Options[1], mUfsDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_FALSE(PlatformUsbRequired(Options, 2, NULL, mDefaultUsbKeyboard));
+
+  //
+  // No options at all
+  //
+  UT_ASSERT_FALSE(PlatformUsbRequired(NULL, 0, NULL, mDefaultUsbKeyboard));
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BootNextDecides(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION BootNext;
+  EFI_DEVICE_PATH_PROTOCOL *   ConIn;
+
+  ConIn = JoinInstances(mSerial, mDefaultUsbKeyboard);
+
+  //
+  // BootNext replaces BootOrder, whatever BootOrder starts with
+  //
+  InitOption(&BootNext, mUsbDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_TRUE(PlatformUsbRequired(&BootNext, 1, ConIn, mDefaultUsbKeyboard));
+
+  InitOption(&BootNext, mUfsDisk, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_FALSE(
+      PlatformUsbRequired(&BootNext, 1, ConIn, mDefaultUsbKeyboard));
+
+  //
+  // The UEFI Shell in the extended FV needs no USB
+  //
+  InitOption(&BootNext, mShellApp, LOAD_OPTION_ACTIVE);
+  UT_ASSERT_FALSE(
+      PlatformUsbRequired(&BootNext, 1, ConIn, mDefaultUsbKeyboard));
+
+  FreePool(ConIn);
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+VOID
+CreateDevicePaths(VOID)
+{
+  EFI_DEVICE_PATH_PROTOCOL *Root;
+
+  //
+  // VenHw(...)/UFS(0,0)/HD(...)
+  //
+  Root = AppendNode(
+      NULL, HARDWARE_DEVICE_PATH, HW_VENDOR_DP, sizeof(VENDOR_DEVICE_PATH));
+  mUfsDisk = AppendNode(
+      DuplicateDevicePath(Root), MESSAGING_DEVICE_PATH, MSG_UFS_DP,
+      sizeof(UFS_DEVICE_PATH));
+  mUfsDisk = AppendNode(
+      mUfsDisk, MEDIA_DEVICE_PATH, MEDIA_HARDDRIVE_DP,
+      sizeof(HARDDRIVE_DEVICE_PATH));
+
+  //
+  // VenHw(...)/USB(0,0)/USB(1,0)/HD(...)
+  //
+  mUsbDisk = AppendNode(
+      DuplicateDevicePath(Root), MESSAGING_DEVICE_PATH, MSG_USB_DP,
+      sizeof(USB_DEVICE_PATH));
+  mUsbDisk = AppendNode(
+      mUsbDisk, MESSAGING_DEVICE_PATH, MSG_USB_DP, sizeof(USB_DEVICE_PATH));
+  mUsbDisk = AppendNode(
+      mUsbDisk, MEDIA_DEVICE_PATH, MEDIA_HARDDRIVE_DP,
+      sizeof(HARDDRIVE_DEVICE_PATH));
+
+  //
+  // VenHw(...)/USB(0,0)/USB(2,0), a keyboard on a given port
+  //
+  mUsbKeyboard = AppendNode(
+      DuplicateDevicePath(Root), MESSAGING_DEVICE_PATH, MSG_USB_DP,
+      sizeof(USB_DEVICE_PATH));
+  mUsbKeyboard = AppendNode(
+      mUsbKeyboard, MESSAGING_DEVICE_PATH, MSG_USB_DP,
+      sizeof(USB_DEVICE_PATH));
+
+  mDefaultUsbKeyboard = CreateDefaultUsbKeyboard();
+
+  //
+  // VenHw(...)/Uart(...)/VenVt100()
+  //
+  mSerial = AppendNode(
+      DuplicateDevicePath(Root), MESSAGING_DEVICE_PATH, MSG_UART_DP,
+      sizeof(UART_DEVICE_PATH));
+  mSerial = AppendNode(
+      mSerial, MESSAGING_DEVICE_PATH, MSG_VENDOR_DP,
+      sizeof(VENDOR_DEVICE_PATH));
+
+  //
+  // Fv(...)/FvFile(...)
+  //
+  mShellApp = AppendNode(
+      NULL, MEDIA_DEVICE_PATH, MEDIA_PIWG_FW_VOL_DP,
+      sizeof(MEDIA_FW_VOL_DEVICE_PATH));
+  mShellApp = AppendNode(
+      mShellApp, MEDIA_DEVICE_PATH, MEDIA_PIWG_FW_FILE_DP,
+      sizeof(MEDIA_FW_VOL_FILEPATH_DEVICE_PATH));
+
+  FreePool(Root);
+}
+
+STATIC
+VOID
+FreeDevicePaths(VOID)
+{
+  FreePool(mUfsDisk);
+  FreePool(mUsbDisk);
+  FreePool(mUsbKeyboard);
+  FreePool(mDefaultUsbKeyboard);
+  FreePool(mSerial);
+  FreePool(mShellApp);
+}
+
+EFI_STATUS
+EFIAPI
+UefiTestMain(VOID)
+{
+  EFI_STATUS                 Status;
+  UNIT_TEST_FRAMEWORK_HANDLE Framework;
+  UNIT_TEST_SUITE_HANDLE     Suite;
+
+  Framework = NULL;
+
+  DEBUG((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework(
+      &Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName,
+      UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR(Status)) {
+    DEBUG(
+        (DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n",
+         Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite(
+      &Suite, Framework, "USB policy", "RenegadePkg.PlatformBm.Usb", NULL,
+      NULL);
+  if (EFI_ERROR(Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase(
+      Suite, "Device paths with and without USB nodes", "DevicePathHasUsb",
+      DevicePathHasUsb, NULL, NULL, NULL);
+  AddTestCase(
+      Suite, "The default USB keyboard in ConIn does not need USB",
+      "DefaultKeyboardIgnored", DefaultKeyboardIgnored, NULL, NULL, NULL);
+  AddTestCase(
+      Suite, "The first active BootOrder option decides",
+      "BootOrderFirstOptionDecides", BootOrderFirstOptionDecides, NULL, NULL,
+      NULL);
+  AddTestCase(
+      Suite, "BootNext decides when it is set", "BootNextDecides",
+      BootNextDecides, NULL, NULL, NULL);
+
+  CreateDevicePaths();
+  Status = RunAllTestSuites(Framework);
+  FreeDevicePaths();
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework(Framework);
+  }
+
+  return Status;
+}
+
+int
+main(int argc, char *argv[])
+{
+  return UefiTestMain();
+}
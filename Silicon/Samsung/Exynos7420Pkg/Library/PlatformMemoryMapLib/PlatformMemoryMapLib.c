@@ -16,7 +16,10 @@ static ARM_MEMORY_REGION_DESCRIPTOR_EX gDeviceMemoryDescriptorEx[] = {
     {"CPU Vectors",       0x40C40000, 0x00010000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
     {"HLOS 0 Split",      0x40C50000, 0x0F3B0000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK_XN},
     {"UEFI FD",           0x50000000, 0x00700000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
-    {"HLOS 0 Split 2",    0x50020000, 0x929E0000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK_XN},
+    {"Persistent Log",    0x50700000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
+    {"FV Cache",          0x50800000, 0x01000000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"FbCon State",       0x51800000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"HLOS 0 Split 2",    0x51900000, 0x91100000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK_XN},
     {"Display Reserved",  0xe2a00000, 0x0e400000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
     {"HLOS 0 Split 3",    0xF0E00000, 0x0DA00000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK_XN},
 
@@ -27,3 +30,15 @@ ARM_MEMORY_REGION_DESCRIPTOR_EX *GetPlatformMemoryMap()
 {
   return gDeviceMemoryDescriptorEx;
 }
+
+// MPIDR affinity of each core, in the order the kernel numbers them
+static UINT64 gCoreMap[] = {
+    0x100, 0x101, 0x102, 0x103,  // Cortex-A53
+    0x000, 0x001, 0x002, 0x003,  // Cortex-A57
+};
+
+UINT64 *GetPlatformCoreMap(UINTN *CoreCount)
+{
+  *CoreCount = ARRAY_SIZE(gCoreMap);
+  return gCoreMap;
+}
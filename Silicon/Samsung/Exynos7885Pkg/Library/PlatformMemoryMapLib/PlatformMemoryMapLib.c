@@ -14,7 +14,10 @@ static ARM_MEMORY_REGION_DESCRIPTOR_EX gDeviceMemoryDescriptorEx[] = {
     {"CPU Vectors",       0x80C40000, 0x00010000, AddMem, SYS_MEM, SYS_MEM_CAP,  BsCode, WRITE_BACK},
     {"HLOS 1",            0x80C50000, 0x0F3B0000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK},
     {"UEFI FD",           0x90000000, 0x00700000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
-    {"HLOS 1.5",          0x90700000, 0x2B500000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK},
+    {"Persistent Log",    0x90700000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
+    {"FV Cache",          0x90800000, 0x01000000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"FbCon State",       0x91800000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"HLOS 1.5",          0x91900000, 0x2A300000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK},
     /*Memory hole 0xbbc00000 -> 0xc0000000*/
     {"HLOS 3",            0xc0000000, 0x2C000000, AddMem, SYS_MEM, SYS_MEM_CAP,  Conv,   WRITE_BACK},
     {"Display Reserved",  0xec000000, 0x00800000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
@@ -26,4 +29,17 @@ static ARM_MEMORY_REGION_DESCRIPTOR_EX gDeviceMemoryDescriptorEx[] = {
 ARM_MEMORY_REGION_DESCRIPTOR_EX *GetPlatformMemoryMap()
 {
   return gDeviceMemoryDescriptorEx;
-}
\ No newline at end of file
+}
+
+// MPIDR affinity of each core, in the order the kernel numbers them
+static UINT64 gCoreMap[] = {
+    0x100, 0x101, 0x102, 0x103,  // Cortex-A53
+    0x200, 0x201,                // Cortex-A53
+    0x000, 0x001,                // Cortex-A73
+};
+
+UINT64 *GetPlatformCoreMap(UINTN *CoreCount)
+{
+  *CoreCount = ARRAY_SIZE(gCoreMap);
+  return gCoreMap;
+}
@@ -9,6 +9,7 @@
 #include <Library/PrintLib.h>
 #include <Library/BaseLib.h>
 #include <Library/MemoryMapHelperLib.h>
+#include <Library/FrameBufferSerialPortLib.h>
 #include <Library/PlatformPrePiLib.h>
 
 #include "PlatformUtils.h"
@@ -16,12 +17,10 @@
 
 VOID InitializeSharedUartBuffers(VOID)
 {
-  INTN* pFbConPosition = (INTN*)(FixedPcdGet32(PcdMipiFrameBufferAddress) + (FixedPcdGet32(PcdMipiFrameBufferWidth) * 
-                                                                              FixedPcdGet32(PcdMipiFrameBufferHeight) * 
-                                                                              FixedPcdGet32(PcdMipiFrameBufferPixelBpp) / 8));
+  PFBCON_SHARED_STATE pFbConState = FBCON_SHARED_STATE_ADDRESS;
 
-  *(pFbConPosition + 0) = 0;
-  *(pFbConPosition + 1) = 0;
+  // Zero every field, so counters added to the header later start clean too
+  ZeroMem(pFbConState, sizeof(*pFbConState));
 }
 
 VOID UartInit(VOID)
@@ -30,6 +29,9 @@ VOID UartInit(VOID)
 
   InitializeSharedUartBuffers();
 
+  // Start this boot's section of the persistent RAM log
+  PersistentLogInitialize();
+
   DEBUG((EFI_D_INFO, "\nRenegade Project edk2-exynos (AArch64)\n"));
   DEBUG(
       (EFI_D_INFO, "Firmware version %s built %a %a\n\n",
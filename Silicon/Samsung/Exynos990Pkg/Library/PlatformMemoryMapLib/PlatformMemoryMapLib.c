@@ -14,7 +14,10 @@ static ARM_MEMORY_REGION_DESCRIPTOR_EX gDeviceMemoryDescriptorEx[] = {
     {"CPU Vectors",       0x80C40000, 0x00010000, AddMem, SYS_MEM, SYS_MEM_CAP,  BsCode, WRITE_BACK},
     {"HLOS 0 Split",      0x80C50000, 0x2AB00000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv, WRITE_BACK_XN},
     {"UEFI FD",           0x90000000, 0x00700000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
-    {"HLOS 0 Split 2",    0x90700000, 0x30B00000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
+    {"Persistent Log",    0x90700000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
+    {"FV Cache",          0x90800000, 0x01000000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"FbCon State",       0x91800000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"HLOS 0 Split 2",    0x91900000, 0x2F900000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
     {"HLOS 1",            0xC1200000, 0x3EE00000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK},
     {"HLOS 2",            0xE1900000, 0x1E700000, AddMem, SYS_MEM, SYS_MEM_CAP,  Conv,   WRITE_BACK},
     {"Display Reserved",  0xf1000000, 0x00800000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
@@ -28,3 +31,16 @@ ARM_MEMORY_REGION_DESCRIPTOR_EX *GetPlatformMemoryMap()
 {
   return gDeviceMemoryDescriptorEx;
 }
+
+// MPIDR affinity of each core, in the order the kernel numbers them
+static UINT64 gCoreMap[] = {
+    0x000, 0x001, 0x002, 0x003,  // Cortex-A55
+    0x004, 0x005,                // Cortex-A76
+    0x100, 0x101,                // Mongoose M5
+};
+
+UINT64 *GetPlatformCoreMap(UINTN *CoreCount)
+{
+  *CoreCount = ARRAY_SIZE(gCoreMap);
+  return gCoreMap;
+}
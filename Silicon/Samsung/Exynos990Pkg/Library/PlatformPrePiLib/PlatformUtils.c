@@ -9,19 +9,19 @@
 #include <Library/PrintLib.h>
 #include <Library/BaseLib.h>
 #include <Library/MemoryMapHelperLib.h>
+#include <Library/FrameBufferSerialPortLib.h>
 #include <Library/PlatformPrePiLib.h>
+#include <Library/PrePiMpLib.h>
 
 #include "PlatformUtils.h"
 
 
 VOID InitializeSharedUartBuffers(VOID)
 {
-  INTN* pFbConPosition = (INTN*)(FixedPcdGet32(PcdMipiFrameBufferAddress) + (FixedPcdGet32(PcdMipiFrameBufferWidth) * 
-                                                                              FixedPcdGet32(PcdMipiFrameBufferHeight) * 
-                                                                              FixedPcdGet32(PcdMipiFrameBufferPixelBpp) / 8));
+  PFBCON_SHARED_STATE pFbConState = FBCON_SHARED_STATE_ADDRESS;
 
-  *(pFbConPosition + 0) = 0;
-  *(pFbConPosition + 1) = 0;
+  // Zero every field, so counters added to the header later start clean too
+  ZeroMem(pFbConState, sizeof(*pFbConState));
 }
 
 VOID UartInit(VOID)
@@ -30,6 +30,9 @@ VOID UartInit(VOID)
 
   InitializeSharedUartBuffers();
 
+  // Start this boot's section of the persistent RAM log
+  PersistentLogInitialize();
+
   DEBUG((EFI_D_INFO, "\nRenegade Project edk2-exynos (AArch64)\n"));
   DEBUG(
       (EFI_D_INFO, "Firmware version %s built %a %a\n\n",
@@ -42,9 +45,6 @@ VOID PlatformInitialize()
   //enable fb
   MmioWrite32(0x19050070,0x1281);
     /* Clear screen at new FB address */ 
-  UINT8 *base = (UINT8 *)0xF1000000ull;
-  for (UINTN i = 0; i < 0x01400000; i++) {
-    base[i] = 0;
-  }
+  PrePiMpZeroMem((VOID *)0xF1000000ull, 0x01400000);
   UartInit();
 }
@@ -0,0 +1,161 @@
+/** @file
+  Reports FrameBufferBltLib throughput in Mpixel/s for each Blt operation on
+  the panel SimpleFbDxe drives.
+
+  BltBenchApp links the platform FrameBufferBltLib and BltBenchAppGeneric the
+  MdeModulePkg one, so running both on the same machine compares the two. The
+  library is called directly on the scanout buffer, without the TPL raise and
+  cache maintenance SimpleFbDxe adds around it.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/FrameBufferBltLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiLib.h>
+
+// Full screen operations per measurement
+#define BLT_BENCH_ROUNDS 100
+
+// Rows VideoToVideo scrolls by, one line of the framebuffer console
+#define BLT_BENCH_SCROLL 24
+
+STATIC CONST CHAR16 *mOperationNames[EfiGraphicsOutputBltOperationMax] = {
+    L"VideoFill", L"VideoToBltBuffer", L"BufferToVideo", L"VideoToVideo",
+};
+
+/**
+  Run Operation BLT_BENCH_ROUNDS times over the whole screen, or all of it
+  but the scrolled out rows for VideoToVideo, and print Mpixel/s.
+**/
+STATIC
+RETURN_STATUS
+BltBenchRun(
+    IN FRAME_BUFFER_CONFIGURE           *Configure,
+    IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *BltBuffer,
+    IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION Operation, IN UINTN Width,
+    IN UINTN Height)
+{
+  RETURN_STATUS Status;
+  UINTN         Round;
+  UINTN         SourceY;
+  UINT64        Start;
+  UINT64        Ns;
+  UINT64        Pixels;
+
+  SourceY = 0;
+  if (Operation == EfiBltVideoToVideo) {
+    SourceY = BLT_BENCH_SCROLL;
+    Height -= BLT_BENCH_SCROLL;
+  }
+
+  Status = RETURN_SUCCESS;
+  Start  = GetPerformanceCounter();
+  for (Round = 0; Round < BLT_BENCH_ROUNDS && !RETURN_ERROR(Status); Round++) {
+    // Vary the fill so it cannot be skipped as a no-op
+    BltBuffer[0].Blue = (UINT8)Round;
+
+    Status = FrameBufferBlt(
+        Configure, BltBuffer, Operation, 0, SourceY, 0, 0, Width, Height, 0);
+  }
+
+  Ns = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+  if (RETURN_ERROR(Status)) {
+    Print(L"  %-16s %r\n", mOperationNames[Operation], Status);
+    return Status;
+  }
+
+  // Pixels per ms is Mpixel/s
+  Pixels = (UINT64)Width * Height * BLT_BENCH_ROUNDS;
+  Print(
+      L"  %-16s %6lu Mpixel/s\n", mOperationNames[Operation],
+      Ns != 0 ? Pixels * 1000 / Ns : 0);
+
+  return RETURN_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+BltBenchAppEntryPoint(
+    IN EFI_HANDLE ImageHandle, IN EFI_SYSTEM_TABLE *SystemTable)
+{
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION Info;
+  EFI_GRAPHICS_OUTPUT_BLT_OPERATION    Operation;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL       *BltBuffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL        Black;
+  FRAME_BUFFER_CONFIGURE              *Configure;
+  UINTN                                ConfigureSize;
+  UINTN                                Width;
+  UINTN                                Height;
+  RETURN_STATUS                        Status;
+
+  Width  = FixedPcdGet32(PcdMipiFrameBufferWidth);
+  Height = FixedPcdGet32(PcdMipiFrameBufferHeight);
+
+  //
+  // The mode SimpleFbDxe reports in its native resolution
+  //
+  ZeroMem(&Info, sizeof(Info));
+  Info.HorizontalResolution = Width;
+  Info.VerticalResolution   = Height;
+  Info.PixelFormat          = PixelBlueGreenRedReserved8BitPerColor;
+  Info.PixelsPerScanLine    = Width;
+
+  Configure     = NULL;
+  ConfigureSize = 0;
+  Status        = FrameBufferBltConfigure(
+      (VOID *)(UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress), &Info, Configure,
+      &ConfigureSize);
+  if (Status == RETURN_BUFFER_TOO_SMALL) {
+    Configure = AllocatePool(ConfigureSize);
+    if (Configure == NULL)
+      return EFI_OUT_OF_RESOURCES;
+
+    Status = FrameBufferBltConfigure(
+        (VOID *)(UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress), &Info,
+        Configure, &ConfigureSize);
+  }
+
+  if (RETURN_ERROR(Status)) {
+    Print(L"BltBench: FrameBufferBltConfigure failed: %r\n", Status);
+    if (Configure != NULL)
+      FreePool(Configure);
+    return Status;
+  }
+
+  BltBuffer = AllocateZeroPool(Width * Height * sizeof(*BltBuffer));
+  if (BltBuffer == NULL) {
+    FreePool(Configure);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Print(
+      L"BltBench: %lux%lu, %u rounds\n", (UINT64)Width, (UINT64)Height,
+      BLT_BENCH_ROUNDS);
+
+  for (Operation = EfiBltVideoFill; Operation < EfiGraphicsOutputBltOperationMax;
+       Operation++) {
+    Status = BltBenchRun(Configure, BltBuffer, Operation, Width, Height);
+    if (RETURN_ERROR(Status))
+      break;
+  }
+
+  //
+  // Leave the screen black rather than covered in the benchmark pattern
+  //
+  ZeroMem(&Black, sizeof(Black));
+  FrameBufferBlt(
+      Configure, &Black, EfiBltVideoFill, 0, 0, 0, 0, Width, Height, 0);
+
+  FreePool(BltBuffer);
+  FreePool(Configure);
+
+  return RETURN_ERROR(Status) ? Status : EFI_SUCCESS;
+}
@@ -0,0 +1,819 @@
+/**
+ * EFI_MP_SERVICES_PROTOCOL on top of PSCI.
+ *
+ * Each procedure runs on a core powered on with CPU_ON just for it, which
+ * powers itself off with CPU_OFF once the procedure returns. No AP is ever
+ * parked in boot services memory, so the OS finds every secondary core off
+ * as PSCI expects and nothing needs tearing down at ExitBootServices.
+ *
+ * The cores a SoC has come from PlatformMemoryMapLib. Cores PSCI does not
+ * know about, or that are already running, are left out.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+#include <PiDxe.h>
+#include <IndustryStandard/ArmStdSmc.h>
+#include <Library/ArmHvcLib.h>
+#include <Library/ArmLib.h>
+#include <Library/ArmSmcLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PlatformMemoryMapLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/LoadedImage.h>
+
+#include "PsciMpServicesDxe.h"
+
+// Read by ApEntryPoint with the MMU off, see PsciMpServicesDxeInitialize
+AP_CONTEXT gApContext;
+
+STATIC CPU_AP_DATA     *mCpuData;
+STATIC UINTN            mNumberOfProcessors;
+STATIC UINTN            mNumberOfEnabledProcessors;
+STATIC EFI_EVENT        mCheckEvent;
+STATIC BOOLEAN          mCheckTimerArmed;
+STATIC STARTUP_ALL_APS  mAllAps;
+
+// The BSP is always processor 0
+#define BSP_INDEX  0
+
+STATIC
+INTN
+PsciCall(
+  IN UINTN FunctionId,
+  IN UINTN Arg1,
+  IN UINTN Arg2,
+  IN UINTN Arg3
+  )
+{
+  ARM_SMC_ARGS SmcArgs;
+  ARM_HVC_ARGS HvcArgs;
+
+  // Without EL3, as on QEMU virt, PSCI is served by the hypervisor call
+  if (FeaturePcdGet (PcdPsciConduitHvc)) {
+    ZeroMem (&HvcArgs, sizeof (HvcArgs));
+    HvcArgs.Arg0 = FunctionId;
+    HvcArgs.Arg1 = Arg1;
+    HvcArgs.Arg2 = Arg2;
+    HvcArgs.Arg3 = Arg3;
+    ArmCallHvc (&HvcArgs);
+    return (INTN)HvcArgs.Arg0;
+  }
+
+  ZeroMem (&SmcArgs, sizeof (SmcArgs));
+  SmcArgs.Arg0 = FunctionId;
+  SmcArgs.Arg1 = Arg1;
+  SmcArgs.Arg2 = Arg2;
+  SmcArgs.Arg3 = Arg3;
+  ArmCallSmc (&SmcArgs);
+  return (INTN)SmcArgs.Arg0;
+}
+
+STATIC
+UINTN
+CurrentProcessorIndex(VOID)
+{
+  UINT64 Mpidr;
+  UINTN  Index;
+
+  Mpidr = ArmReadMpidr () & MPIDR_AFFINITY_MASK;
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    if (mCpuData[Index].Info.ProcessorId == Mpidr) {
+      return Index;
+    }
+  }
+
+  return mNumberOfProcessors;
+}
+
+STATIC
+BOOLEAN
+IsBsp(VOID)
+{
+  return CurrentProcessorIndex () == BSP_INDEX;
+}
+
+STATIC
+BOOLEAN
+IsApEnabled(
+  IN CPU_AP_DATA *Cpu
+  )
+{
+  return (Cpu->Info.StatusFlag & PROCESSOR_ENABLED_BIT) != 0;
+}
+
+// An AP whose caller gave up on it is reclaimed once it has finished
+STATIC
+BOOLEAN
+IsApIdle(
+  IN CPU_AP_DATA *Cpu
+  )
+{
+  if ((Cpu->Owner == ApOwnerNone) && (Cpu->State == CpuStateFinished)) {
+    Cpu->State = CpuStateIdle;
+  }
+
+  return (Cpu->Owner == ApOwnerNone) && (Cpu->State == CpuStateIdle);
+}
+
+STATIC
+BOOLEAN
+TimeoutExpired(
+  IN UINT64 StartTicks,
+  IN UINTN  TimeoutUs
+  )
+{
+  if (TimeoutUs == 0) {
+    return FALSE;
+  }
+
+  return GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks) >=
+         MultU64x32 (TimeoutUs, 1000);
+}
+
+// Runs on the AP with the BSP's page tables and its own stack
+VOID
+EFIAPI
+ApProcedureEntry(
+  IN UINTN Index
+  )
+{
+  CPU_AP_DATA *Cpu;
+
+  Cpu = &mCpuData[Index];
+  Cpu->Procedure (Cpu->Argument);
+
+  // Whatever the procedure wrote must be visible before the BSP sees it done
+  ArmDataMemoryBarrier ();
+  Cpu->State = CpuStateFinished;
+  ArmDataSynchronizationBarrier ();
+
+  PsciCall (ARM_SMC_ID_PSCI_CPU_OFF, 0, 0, 0);
+
+  // CPU_OFF only returns on failure
+  CpuDeadLoop ();
+}
+
+// Power the AP on to run Procedure
+STATIC
+EFI_STATUS
+DispatchAp(
+  IN UINTN            Index,
+  IN EFI_AP_PROCEDURE Procedure,
+  IN VOID            *Argument
+  )
+{
+  CPU_AP_DATA *Cpu;
+  UINTN        Retries;
+  INTN         Ret;
+
+  Cpu = &mCpuData[Index];
+  Cpu->Procedure = Procedure;
+  Cpu->Argument  = Argument;
+  Cpu->State     = CpuStateBusy;
+  ArmDataSynchronizationBarrier ();
+
+  // An AP reports Finished just before CPU_OFF, it may still be going down
+  for (Retries = 0; Retries < AP_POWER_OFF_RETRIES; Retries++) {
+    Ret = PsciCall (
+            ARM_SMC_ID_PSCI_AFFINITY_INFO_AARCH64,
+            Cpu->Info.ProcessorId, 0, 0);
+    if (Ret == PSCI_AFFINITY_OFF) {
+      break;
+    }
+    MicroSecondDelay (AP_POWER_OFF_POLL_US);
+  }
+
+  Ret = PsciCall (
+          ARM_SMC_ID_PSCI_CPU_ON_AARCH64,
+          Cpu->Info.ProcessorId, (UINTN)ApEntryPoint, Index);
+  if (Ret != ARM_SMC_PSCI_RET_SUCCESS) {
+    DEBUG((
+        EFI_D_ERROR, "%a: CPU_ON of 0x%lx failed: %ld\n",
+        __func__, Cpu->Info.ProcessorId, Ret));
+    Cpu->State = CpuStateIdle;
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+StartCheckTimer(VOID)
+{
+  if (!mCheckTimerArmed) {
+    gBS->SetTimer (mCheckEvent, TimerPeriodic, AP_CHECK_INTERVAL);
+    mCheckTimerArmed = TRUE;
+  }
+}
+
+// Start the next AP of a SingleThread StartupAllAPs
+STATIC
+VOID
+DispatchNextAllAps(VOID)
+{
+  UINTN        Index;
+  CPU_AP_DATA *Cpu;
+
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if (Cpu->Owner != ApOwnerStartupAllApsPending) {
+      continue;
+    }
+
+    Cpu->Owner = ApOwnerStartupAllAps;
+    if (!EFI_ERROR (DispatchAp (Index, mAllAps.Procedure, mAllAps.Argument))) {
+      return;
+    }
+
+    Cpu->Owner        = ApOwnerNone;
+    Cpu->AllApsFailed = TRUE;
+  }
+}
+
+// Hand the result of StartupAllAPs to its caller
+STATIC
+VOID
+CompleteAllAps(VOID)
+{
+  UINTN        Index;
+  UINTN        Failed;
+  UINTN       *FailedList;
+  CPU_AP_DATA *Cpu;
+
+  Failed = 0;
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Cpu->Owner == ApOwnerStartupAllApsPending) ||
+        (Cpu->Owner == ApOwnerStartupAllAps) || Cpu->AllApsFailed) {
+      Failed++;
+    }
+  }
+
+  FailedList = NULL;
+  if (Failed != 0) {
+    FailedList = AllocatePool ((Failed + 1) * sizeof (UINTN));
+  }
+
+  Failed = 0;
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Cpu->Owner == ApOwnerStartupAllApsPending) ||
+        (Cpu->Owner == ApOwnerStartupAllAps) || Cpu->AllApsFailed) {
+      if (FailedList != NULL) {
+        FailedList[Failed++] = Index;
+      }
+      // A running AP is reclaimed by IsApIdle when it finishes
+      Cpu->Owner        = ApOwnerNone;
+      Cpu->AllApsFailed = FALSE;
+    }
+  }
+
+  if (FailedList != NULL) {
+    FailedList[Failed] = END_OF_CPU_LIST;
+  }
+
+  if (mAllAps.FailedCpuList != NULL) {
+    *mAllAps.FailedCpuList = FailedList;
+  } else if (FailedList != NULL) {
+    FreePool (FailedList);
+  }
+
+  mAllAps.InProgress = FALSE;
+  if (mAllAps.WaitEvent != NULL) {
+    gBS->SignalEvent (mAllAps.WaitEvent);
+  }
+}
+
+// Advance StartupAllAPs, TRUE once it has completed
+STATIC
+BOOLEAN
+CheckAllAps(VOID)
+{
+  UINTN        Index;
+  BOOLEAN      Running;
+  BOOLEAN      Pending;
+  CPU_AP_DATA *Cpu;
+
+  Running = FALSE;
+  Pending = FALSE;
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Cpu->Owner == ApOwnerStartupAllAps) &&
+        (Cpu->State == CpuStateFinished)) {
+      ArmDataMemoryBarrier ();
+      Cpu->State = CpuStateIdle;
+      Cpu->Owner = ApOwnerNone;
+    }
+
+    Running |= (Cpu->Owner == ApOwnerStartupAllAps);
+    Pending |= (Cpu->Owner == ApOwnerStartupAllApsPending);
+  }
+
+  if (!Running && Pending) {
+    DispatchNextAllAps ();
+    return FALSE;
+  }
+
+  if (Running) {
+    if (!TimeoutExpired (mAllAps.StartTicks, mAllAps.TimeoutUs)) {
+      return FALSE;
+    }
+    mAllAps.Status = EFI_TIMEOUT;
+  }
+
+  CompleteAllAps ();
+  return TRUE;
+}
+
+// Advance StartupThisAP on Cpu, TRUE once it has completed
+STATIC
+BOOLEAN
+CheckThisAp(
+  IN  CPU_AP_DATA *Cpu,
+  OUT EFI_STATUS  *Status
+  )
+{
+  EFI_EVENT WaitEvent;
+
+  if (Cpu->State == CpuStateFinished) {
+    ArmDataMemoryBarrier ();
+    Cpu->State = CpuStateIdle;
+    *Status = EFI_SUCCESS;
+  } else if (TimeoutExpired (Cpu->StartTicks, Cpu->TimeoutUs)) {
+    // A running AP is reclaimed by IsApIdle when it finishes
+    *Status = EFI_TIMEOUT;
+  } else {
+    return FALSE;
+  }
+
+  if (Cpu->Finished != NULL) {
+    *Cpu->Finished = !EFI_ERROR (*Status);
+  }
+
+  WaitEvent      = Cpu->WaitEvent;
+  Cpu->WaitEvent = NULL;
+  Cpu->Owner     = ApOwnerNone;
+  if (WaitEvent != NULL) {
+    gBS->SignalEvent (WaitEvent);
+  }
+
+  return TRUE;
+}
+
+// Polls the non-blocking requests, blocking ones poll themselves
+STATIC
+VOID
+EFIAPI
+CheckApsEvent(
+  IN EFI_EVENT Event,
+  IN VOID     *Context
+  )
+{
+  UINTN        Index;
+  BOOLEAN      Outstanding;
+  EFI_STATUS   Status;
+  CPU_AP_DATA *Cpu;
+
+  Outstanding = FALSE;
+  if (mAllAps.InProgress && (mAllAps.WaitEvent != NULL)) {
+    Outstanding = !CheckAllAps ();
+  }
+
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Cpu->Owner == ApOwnerStartupThisAp) && (Cpu->WaitEvent != NULL)) {
+      Outstanding |= !CheckThisAp (Cpu, &Status);
+    }
+  }
+
+  if (!Outstanding) {
+    gBS->SetTimer (mCheckEvent, TimerCancel, 0);
+    mCheckTimerArmed = FALSE;
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+GetNumberOfProcessors(
+  IN  EFI_MP_SERVICES_PROTOCOL *This,
+  OUT UINTN                    *NumberOfProcessors,
+  OUT UINTN                    *NumberOfEnabledProcessors
+  )
+{
+  if ((NumberOfProcessors == NULL) || (NumberOfEnabledProcessors == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!IsBsp ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  *NumberOfProcessors        = mNumberOfProcessors;
+  *NumberOfEnabledProcessors = mNumberOfEnabledProcessors;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+GetProcessorInfo(
+  IN  EFI_MP_SERVICES_PROTOCOL  *This,
+  IN  UINTN                      ProcessorNumber,
+  OUT EFI_PROCESSOR_INFORMATION *ProcessorInfoBuffer
+  )
+{
+  CPU_AP_DATA *Cpu;
+  BOOLEAN      Extended;
+
+  if (ProcessorInfoBuffer == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!IsBsp ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Extended         = (ProcessorNumber & CPU_V2_EXTENDED_TOPOLOGY) != 0;
+  ProcessorNumber &= ~(UINTN)CPU_V2_EXTENDED_TOPOLOGY;
+  if (ProcessorNumber >= mNumberOfProcessors) {
+    return EFI_NOT_FOUND;
+  }
+
+  Cpu = &mCpuData[ProcessorNumber];
+  ProcessorInfoBuffer->ProcessorId = Cpu->Info.ProcessorId;
+  ProcessorInfoBuffer->StatusFlag  = Cpu->Info.StatusFlag;
+  ProcessorInfoBuffer->Location    = Cpu->Info.Location;
+  if (Extended) {
+    ProcessorInfoBuffer->ExtendedInformation = Cpu->Info.ExtendedInformation;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+StartupAllAPs(
+  IN  EFI_MP_SERVICES_PROTOCOL *This,
+  IN  EFI_AP_PROCEDURE          Procedure,
+  IN  BOOLEAN                   SingleThread,
+  IN  EFI_EVENT                 WaitEvent OPTIONAL,
+  IN  UINTN                     TimeoutInMicroSeconds,
+  IN  VOID                     *ProcedureArgument OPTIONAL,
+  OUT UINTN                   **FailedCpuList OPTIONAL
+  )
+{
+  UINTN        Index;
+  UINTN        Enabled;
+  CPU_AP_DATA *Cpu;
+
+  if (!IsBsp ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Procedure == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mAllAps.InProgress) {
+    return EFI_NOT_READY;
+  }
+
+  Enabled = 0;
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Index == BSP_INDEX) || !IsApEnabled (Cpu)) {
+      continue;
+    }
+    if (!IsApIdle (Cpu)) {
+      return EFI_NOT_READY;
+    }
+    Enabled++;
+  }
+
+  if (Enabled == 0) {
+    return EFI_NOT_STARTED;
+  }
+
+  if (FailedCpuList != NULL) {
+    *FailedCpuList = NULL;
+  }
+
+  mAllAps.Procedure     = Procedure;
+  mAllAps.Argument      = ProcedureArgument;
+  mAllAps.WaitEvent     = WaitEvent;
+  mAllAps.FailedCpuList = FailedCpuList;
+  mAllAps.StartTicks    = GetPerformanceCounter ();
+  mAllAps.TimeoutUs     = TimeoutInMicroSeconds;
+  mAllAps.Status        = EFI_SUCCESS;
+
+  for (Index = 0; Index < mNumberOfProcessors; Index++) {
+    Cpu = &mCpuData[Index];
+    if ((Index != BSP_INDEX) && IsApEnabled (Cpu)) {
+      Cpu->Owner        = ApOwnerStartupAllApsPending;
+      Cpu->AllApsFailed = FALSE;
+    }
+  }
+
+  if (SingleThread) {
+    DispatchNextAllAps ();
+  } else {
+    for (Index = 0; Index < mNumberOfProcessors; Index++) {
+      Cpu = &mCpuData[Index];
+      if (Cpu->Owner != ApOwnerStartupAllApsPending) {
+        continue;
+      }
+      Cpu->Owner = ApOwnerStartupAllAps;
+      if (EFI_ERROR (DispatchAp (Index, Procedure, ProcedureArgument))) {
+        Cpu->Owner        = ApOwnerNone;
+        Cpu->AllApsFailed = TRUE;
+      }
+    }
+  }
+
+  // The periodic check only looks at the request once it is complete
+  MemoryFence ();
+  mAllAps.InProgress = TRUE;
+
+  if (WaitEvent != NULL) {
+    StartCheckTimer ();
+    return EFI_SUCCESS;
+  }
+
+  while (!CheckAllAps ()) {
+    CpuPause ();
+  }
+
+  return mAllAps.Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+StartupThisAP(
+  IN  EFI_MP_SERVICES_PROTOCOL *This,
+  IN  EFI_AP_PROCEDURE          Procedure,
+  IN  UINTN                     ProcessorNumber,
+  IN  EFI_EVENT                 WaitEvent OPTIONAL,
+  IN  UINTN                     TimeoutInMicroseconds,
+  IN  VOID                     *ProcedureArgument OPTIONAL,
+  OUT BOOLEAN                  *Finished OPTIONAL
+  )
+{
+  EFI_STATUS   Status;
+  CPU_AP_DATA *Cpu;
+
+  if (!IsBsp ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (ProcessorNumber >= mNumberOfProcessors) {
+    return EFI_NOT_FOUND;
+  }
+
+  Cpu = &mCpuData[ProcessorNumber];
+  if ((Procedure == NULL) || (ProcessorNumber == BSP_INDEX) ||
+      !IsApEnabled (Cpu)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!IsApIdle (Cpu)) {
+    return EFI_NOT_READY;
+  }
+
+  if (Finished != NULL) {
+    *Finished = FALSE;
+  }
+
+  Cpu->WaitEvent  = WaitEvent;
+  Cpu->Finished   = Finished;
+  Cpu->StartTicks = GetPerformanceCounter ();
+  Cpu->TimeoutUs  = TimeoutInMicroseconds;
+
+  Status = DispatchAp (ProcessorNumber, Procedure, ProcedureArgument);
+  if (EFI_ERROR (Status)) {
+    Cpu->WaitEvent = NULL;
+    return Status;
+  }
+
+  MemoryFence ();
+  Cpu->Owner = ApOwnerStartupThisAp;
+
+  if (WaitEvent != NULL) {
+    StartCheckTimer ();
+    return EFI_SUCCESS;
+  }
+
+  while (!CheckThisAp (Cpu, &Status)) {
+    CpuPause ();
+  }
+
+  return Status;
+}
+
+// There is no way to hand the BSP role over with PSCI
+STATIC
+EFI_STATUS
+EFIAPI
+SwitchBSP(
+  IN EFI_MP_SERVICES_PROTOCOL *This,
+  IN UINTN                     ProcessorNumber,
+  IN BOOLEAN                   EnableOldBSP
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+EnableDisableAP(
+  IN EFI_MP_SERVICES_PROTOCOL *This,
+  IN UINTN                     ProcessorNumber,
+  IN BOOLEAN                   EnableAP,
+  IN UINT32                   *HealthFlag OPTIONAL
+  )
+{
+  CPU_AP_DATA *Cpu;
+
+  if (!IsBsp ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (ProcessorNumber >= mNumberOfProcessors) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (ProcessorNumber == BSP_INDEX) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Cpu = &mCpuData[ProcessorNumber];
+  if (!IsApIdle (Cpu)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EnableAP && !IsApEnabled (Cpu)) {
+    Cpu->Info.StatusFlag |= PROCESSOR_ENABLED_BIT;
+    mNumberOfEnabledProcessors++;
+  } else if (!EnableAP && IsApEnabled (Cpu)) {
+    Cpu->Info.StatusFlag &= ~PROCESSOR_ENABLED_BIT;
+    mNumberOfEnabledProcessors--;
+  }
+
+  if (HealthFlag != NULL) {
+    Cpu->Info.StatusFlag &= ~PROCESSOR_HEALTH_STATUS_BIT;
+    Cpu->Info.StatusFlag |= *HealthFlag & PROCESSOR_HEALTH_STATUS_BIT;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+WhoAmI(
+  IN  EFI_MP_SERVICES_PROTOCOL *This,
+  OUT UINTN                    *ProcessorNumber
+  )
+{
+  UINTN Index;
+
+  if (ProcessorNumber == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Index = CurrentProcessorIndex ();
+  if (Index >= mNumberOfProcessors) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  *ProcessorNumber = Index;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_MP_SERVICES_PROTOCOL mMpServices = {
+  GetNumberOfProcessors,
+  GetProcessorInfo,
+  StartupAllAPs,
+  StartupThisAP,
+  SwitchBSP,
+  EnableDisableAP,
+  WhoAmI
+};
+
+STATIC
+VOID
+AddProcessor(
+  IN UINT64  Mpidr,
+  IN BOOLEAN IsBootProcessor
+  )
+{
+  EFI_PROCESSOR_INFORMATION *Info;
+
+  Info = &mCpuData[mNumberOfProcessors++].Info;
+  Info->ProcessorId = Mpidr;
+  Info->StatusFlag  = PROCESSOR_ENABLED_BIT | PROCESSOR_HEALTH_STATUS_BIT;
+  if (IsBootProcessor) {
+    Info->StatusFlag |= PROCESSOR_AS_BSP_BIT;
+  }
+
+  // Aff0 is the thread on multithreaded cores, the core within a cluster otherwise
+  if ((ArmReadMpidr () & MPIDR_MT) != 0) {
+    Info->Location.Package = MPIDR_AFF2 (Mpidr);
+    Info->Location.Core    = MPIDR_AFF1 (Mpidr);
+    Info->Location.Thread  = MPIDR_AFF0 (Mpidr);
+  } else {
+    Info->Location.Package = MPIDR_AFF1 (Mpidr);
+    Info->Location.Core    = MPIDR_AFF0 (Mpidr);
+    Info->Location.Thread  = 0;
+  }
+
+  Info->ExtendedInformation.Location2.Package = Info->Location.Package;
+  Info->ExtendedInformation.Location2.Core    = Info->Location.Core;
+  Info->ExtendedInformation.Location2.Thread  = Info->Location.Thread;
+
+  mNumberOfEnabledProcessors++;
+}
+
+EFI_STATUS
+EFIAPI
+PsciMpServicesDxeInitialize(
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE *SystemTable
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_LOADED_IMAGE_PROTOCOL *LoadedImage;
+  UINT64                    *CoreMap;
+  UINTN                      CoreCount;
+  UINT64                     BspMpidr;
+  UINTN                      Index;
+  INTN                       Ret;
+  VOID                      *Stacks;
+
+  CoreMap  = GetPlatformCoreMap (&CoreCount);
+  BspMpidr = ArmReadMpidr () & MPIDR_AFFINITY_MASK;
+
+  mCpuData = AllocateZeroPool ((CoreCount + 1) * sizeof (CPU_AP_DATA));
+  if (mCpuData == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AddProcessor (BspMpidr, TRUE);
+  for (Index = 0; Index < CoreCount; Index++) {
+    if (CoreMap[Index] == BspMpidr) {
+      continue;
+    }
+
+    Ret = PsciCall (
+            ARM_SMC_ID_PSCI_AFFINITY_INFO_AARCH64, CoreMap[Index], 0, 0);
+    if (Ret != PSCI_AFFINITY_OFF) {
+      DEBUG((
+          EFI_D_WARN, "%a: leaving out core 0x%lx, AFFINITY_INFO %ld\n",
+          __func__, CoreMap[Index], Ret));
+      continue;
+    }
+
+    AddProcessor (CoreMap[Index], FALSE);
+  }
+
+  Stacks = AllocatePages (EFI_SIZE_TO_PAGES (mNumberOfProcessors * AP_STACK_SIZE));
+  if (Stacks == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->HandleProtocol (
+                  ImageHandle, &gEfiLoadedImageProtocolGuid,
+                  (VOID **)&LoadedImage);
+  ASSERT_EFI_ERROR (Status);
+
+  CaptureApContext (&gApContext);
+  gApContext.StacksBase = (UINTN)Stacks;
+  gApContext.StackSize  = AP_STACK_SIZE;
+
+  // APs run ApEntryPoint and read gApContext with their caches off
+  WriteBackDataCacheRange (LoadedImage->ImageBase, LoadedImage->ImageSize);
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK,
+                  CheckApsEvent, NULL, &mCheckEvent);
+  ASSERT_EFI_ERROR (Status);
+
+  DEBUG((
+      EFI_D_INFO, "%a: %lu processors, BSP 0x%lx\n",
+      __func__, mNumberOfProcessors, BspMpidr));
+
+  return gBS->InstallMultipleProtocolInterfaces (
+                &ImageHandle, &gEfiMpServiceProtocolGuid, &mMpServices, NULL);
+}
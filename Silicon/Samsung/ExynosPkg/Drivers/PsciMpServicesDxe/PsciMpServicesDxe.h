@@ -0,0 +1,93 @@
+#ifndef _PSCI_MP_SERVICES_DXE_H_
+#define _PSCI_MP_SERVICES_DXE_H_
+
+#include <Protocol/MpService.h>
+
+// Bytes of stack each AP gets while it runs a procedure
+#define AP_STACK_SIZE             SIZE_32KB
+
+// How often non-blocking requests are checked, in 100ns units
+#define AP_CHECK_INTERVAL         100000
+
+// How long to wait for a core that just finished to report itself off
+#define AP_POWER_OFF_POLL_US      10
+#define AP_POWER_OFF_RETRIES      10000
+
+// PSCI AFFINITY_INFO return values
+#define PSCI_AFFINITY_ON          0
+#define PSCI_AFFINITY_OFF         1
+
+#define MPIDR_MT                  BIT24
+#define MPIDR_AFFINITY_MASK       0xFF00FFFFFFULL
+#define MPIDR_AFF0(Mpidr)         ((UINT32)(Mpidr) & 0xFF)
+#define MPIDR_AFF1(Mpidr)         ((UINT32)((Mpidr) >> 8) & 0xFF)
+#define MPIDR_AFF2(Mpidr)         ((UINT32)((Mpidr) >> 16) & 0xFF)
+
+// What the BSP runs with, loaded by ApEntryPoint before it turns the MMU on.
+// The offsets are hardcoded in AArch64/MpFuncs.S.
+typedef struct {
+  UINT64  Mair;          // 0x00
+  UINT64  Tcr;           // 0x08
+  UINT64  Ttbr0;         // 0x10
+  UINT64  Sctlr;         // 0x18
+  UINT64  Vbar;          // 0x20
+  UINT64  Hcr;           // 0x28, EL2 only
+  UINT64  StacksBase;    // 0x30
+  UINT64  StackSize;     // 0x38
+} AP_CONTEXT;
+
+typedef enum {
+  CpuStateIdle,
+  CpuStateBusy,
+  CpuStateFinished
+} CPU_STATE;
+
+// Which request an AP is working for
+typedef enum {
+  ApOwnerNone,
+  ApOwnerStartupThisAp,
+  ApOwnerStartupAllApsPending,
+  ApOwnerStartupAllAps
+} AP_OWNER;
+
+typedef struct {
+  EFI_PROCESSOR_INFORMATION  Info;
+  // Set to Busy by the BSP, to Finished by the AP
+  volatile UINT32            State;
+  AP_OWNER                   Owner;
+  EFI_AP_PROCEDURE           Procedure;
+  VOID                       *Argument;
+  BOOLEAN                    AllApsFailed;
+
+  // StartupThisAP
+  EFI_EVENT                  WaitEvent;
+  BOOLEAN                    *Finished;
+  UINT64                     StartTicks;
+  UINTN                      TimeoutUs;
+} CPU_AP_DATA;
+
+// The StartupAllAPs request in flight, there is at most one
+typedef struct {
+  BOOLEAN                    InProgress;
+  EFI_AP_PROCEDURE           Procedure;
+  VOID                       *Argument;
+  EFI_EVENT                  WaitEvent;
+  UINTN                      **FailedCpuList;
+  UINT64                     StartTicks;
+  UINTN                      TimeoutUs;
+  EFI_STATUS                 Status;
+} STARTUP_ALL_APS;
+
+// Started by PSCI CPU_ON, with the MMU off and the CPU_AP_DATA index in x0
+VOID
+ApEntryPoint (
+  VOID
+  );
+
+// Saves the translation regime of the calling core
+VOID
+CaptureApContext (
+  OUT AP_CONTEXT *Context
+  );
+
+#endif /* _PSCI_MP_SERVICES_DXE_H_ */
@@ -5,11 +5,14 @@
 #include <Library/DebugLib.h>
 #include <Library/DxeServicesTableLib.h>
 #include <Library/FrameBufferBltLib.h>
+#include <Library/FrameBufferSerialPortLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <PiDxe.h>
+#include <Guid/EventGroup.h>
 #include <Protocol/GraphicsOutput.h>
 #include <Uefi.h>
 
@@ -58,6 +61,48 @@ DISPLAY_DEVICE_PATH mDisplayDevicePath = {
 
 STATIC FRAME_BUFFER_CONFIGURE *mFrameBufferBltLibConfigure;
 STATIC UINTN                   mFrameBufferBltLibConfigureSize;
+STATIC EFI_EVENT               mExitBootServicesEvent;
+STATIC EFI_EVENT               mConsoleFlushEvent;
+STATIC EFI_EVENT               mPresentEvent;
+
+// Partial console lines are rendered at most this late (100ns units)
+#define CONSOLE_FLUSH_PERIOD EFI_TIMER_PERIOD_MILLISECONDS(100)
+
+// Shadow buffer Blts reach the panel at most this late (100ns units)
+#define SHADOW_PRESENT_PERIOD EFI_TIMER_PERIOD_MILLISECONDS(16)
+
+// Damaged rectangles kept apart before they are folded into one
+#define SHADOW_DAMAGE_RECTS 8
+
+typedef struct {
+  UINTN Left;
+  UINTN Top;
+  UINTN Right;
+  UINTN Bottom;
+} DISPLAY_RECT;
+
+// Write-back copy of the framebuffer that Blts go to when
+// PcdSimpleFbShadowBuffer is set, and what it still has to present
+STATIC UINT32      *mShadowBuffer;
+STATIC DISPLAY_RECT mDamage[SHADOW_DAMAGE_RECTS];
+STATIC UINTN        mDamageCount;
+
+// Mode 0 is the panel; the others render at 1/n and are pixel-multiplied
+STATIC CONST UINT8 mModeScale[] = {1, 2, 3};
+
+STATIC EFI_GRAPHICS_OUTPUT_MODE_INFORMATION mModeInfo[ARRAY_SIZE(mModeScale)];
+STATIC UINT32                              *mScanoutBuffer;
+// Blt target of the current scaled mode, NULL in mode 0
+STATIC UINT32                              *mScaledBuffer;
+STATIC UINTN                                mScale = 1;
+
+// Blt cost per operation, reported at ExitBootServices
+STATIC UINT64 mBltCalls[EfiGraphicsOutputBltOperationMax];
+STATIC UINT64 mBltPixels[EfiGraphicsOutputBltOperationMax];
+STATIC UINT64 mBltTicks[EfiGraphicsOutputBltOperationMax];
+
+STATIC CONST CHAR8 *mBltOperationName[EfiGraphicsOutputBltOperationMax] = {
+    "VideoFill", "VideoToBltBuffer", "BufferToVideo", "VideoToVideo"};
 
 STATIC
 EFI_STATUS
@@ -85,6 +130,146 @@ DisplayBlt(
 STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL mDisplay = {
     DisplayQueryMode, DisplaySetMode, DisplayBlt, NULL};
 
+STATIC
+VOID
+DisplayFlushRect(IN UINTN X, IN UINTN Y, IN UINTN Width, IN UINTN Height)
+{
+  UINTN  LineLength;
+  UINTN  RectLength;
+  UINT8 *Line;
+  UINTN  Row;
+
+  LineLength = mModeInfo[0].PixelsPerScanLine * FB_BYTES_PER_PIXEL;
+  RectLength = Width * FB_BYTES_PER_PIXEL;
+  Line       = (UINT8 *)mScanoutBuffer + Y * LineLength + X * FB_BYTES_PER_PIXEL;
+
+  if (Width == 0 || Height == 0)
+    return;
+
+  if (RectLength * 2 >= LineLength) {
+    // Wide rectangles: clean the whole band of rows in one go
+    Line -= X * FB_BYTES_PER_PIXEL;
+    WriteBackInvalidateDataCacheRange(Line, Height * LineLength);
+    FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned += Height * LineLength;
+    return;
+  }
+
+  // Narrow rectangles (cursor, glyphs): clean each row's span only
+  for (Row = 0; Row < Height; Row++) {
+    WriteBackInvalidateDataCacheRange(Line, RectLength);
+    Line += LineLength;
+  }
+  FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned += Height * RectLength;
+}
+
+// Called at TPL_NOTIFY
+STATIC
+VOID
+DisplayAddDamage(IN UINTN X, IN UINTN Y, IN UINTN Width, IN UINTN Height)
+{
+  DISPLAY_RECT Rect = {X, Y, X + Width, Y + Height};
+  UINTN        Index;
+
+  // Swallow every pending rectangle this one overlaps or touches; scrolls and
+  // repeated glyph draws then stay a single copy
+  Index = 0;
+  while (Index < mDamageCount) {
+    if (Rect.Left > mDamage[Index].Right || mDamage[Index].Left > Rect.Right ||
+        Rect.Top > mDamage[Index].Bottom || mDamage[Index].Top > Rect.Bottom) {
+      Index++;
+      continue;
+    }
+
+    Rect.Left   = MIN(Rect.Left, mDamage[Index].Left);
+    Rect.Top    = MIN(Rect.Top, mDamage[Index].Top);
+    Rect.Right  = MAX(Rect.Right, mDamage[Index].Right);
+    Rect.Bottom = MAX(Rect.Bottom, mDamage[Index].Bottom);
+
+    // The grown rectangle may now reach ones already passed over
+    mDamage[Index] = mDamage[--mDamageCount];
+    Index          = 0;
+  }
+
+  // Out of slots: present the bounding box of everything instead
+  if (mDamageCount == SHADOW_DAMAGE_RECTS) {
+    for (Index = 0; Index < mDamageCount; Index++) {
+      Rect.Left   = MIN(Rect.Left, mDamage[Index].Left);
+      Rect.Top    = MIN(Rect.Top, mDamage[Index].Top);
+      Rect.Right  = MAX(Rect.Right, mDamage[Index].Right);
+      Rect.Bottom = MAX(Rect.Bottom, mDamage[Index].Bottom);
+    }
+    mDamageCount = 0;
+  }
+
+  mDamage[mDamageCount++] = Rect;
+}
+
+// Copy the damaged parts of the shadow buffer to the scanout buffer
+STATIC
+VOID
+DisplayPresent(VOID)
+{
+  UINTN   Stride      = mModeInfo[0].PixelsPerScanLine;
+  UINT32 *FrameBuffer = mScanoutBuffer;
+  UINTN   Index;
+  UINTN   Row;
+  EFI_TPL Tpl;
+
+  if (mShadowBuffer == NULL)
+    return;
+
+  Tpl = gBS->RaiseTPL(TPL_NOTIFY);
+  for (Index = 0; Index < mDamageCount; Index++) {
+    for (Row = mDamage[Index].Top; Row < mDamage[Index].Bottom; Row++)
+      CopyMem(
+          FrameBuffer + Row * Stride + mDamage[Index].Left,
+          mShadowBuffer + Row * Stride + mDamage[Index].Left,
+          (mDamage[Index].Right - mDamage[Index].Left) * FB_BYTES_PER_PIXEL);
+
+    DisplayFlushRect(
+        mDamage[Index].Left, mDamage[Index].Top,
+        mDamage[Index].Right - mDamage[Index].Left,
+        mDamage[Index].Bottom - mDamage[Index].Top);
+  }
+  mDamageCount = 0;
+  gBS->RestoreTPL(Tpl);
+}
+
+// Called at TPL_NOTIFY. Widen a rectangle of the scaled mode buffer onto the
+// panel: each source row is multiplied out once, the rows below it are copies.
+STATIC
+VOID
+DisplayUpscale(IN UINTN X, IN UINTN Y, IN UINTN Width, IN UINTN Height)
+{
+  UINTN   Stride       = mModeInfo[0].PixelsPerScanLine;
+  UINTN   ScaledStride = mDisplay.Mode->Info->PixelsPerScanLine;
+  UINT32 *Panel        = mShadowBuffer != NULL ? mShadowBuffer : mScanoutBuffer;
+  UINT32 *Source;
+  UINT32 *Line;
+  UINTN   Row;
+  UINTN   Col;
+  UINTN   Rep;
+
+  for (Row = Y; Row < Y + Height; Row++) {
+    Source = mScaledBuffer + Row * ScaledStride + X;
+    Line   = Panel + Row * mScale * Stride + X * mScale;
+
+    if (mScale == 2) {
+      // One 64-bit store per source pixel
+      for (Col = 0; Col < Width; Col++)
+        ((UINT64 *)Line)[Col] = Source[Col] | LShiftU64(Source[Col], 32);
+    }
+    else {
+      for (Col = 0; Col < Width; Col++)
+        for (Rep = 0; Rep < mScale; Rep++)
+          Line[Col * mScale + Rep] = Source[Col];
+    }
+
+    for (Rep = 1; Rep < mScale; Rep++)
+      CopyMem(Line + Rep * Stride, Line, Width * mScale * FB_BYTES_PER_PIXEL);
+  }
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -93,18 +278,20 @@ DisplayQueryMode(
     OUT UINTN *SizeOfInfo, OUT EFI_GRAPHICS_OUTPUT_MODE_INFORMATION **Info)
 {
   EFI_STATUS Status;
+
+  if (ModeNumber >= This->Mode->MaxMode || SizeOfInfo == NULL || Info == NULL)
+    return EFI_INVALID_PARAMETER;
+
   Status = gBS->AllocatePool(
       EfiBootServicesData, sizeof(EFI_GRAPHICS_OUTPUT_MODE_INFORMATION),
       (VOID **)Info);
 
   ASSERT_EFI_ERROR(Status);
+  if (EFI_ERROR(Status))
+    return Status;
 
-  *SizeOfInfo                   = sizeof(EFI_GRAPHICS_OUTPUT_MODE_INFORMATION);
-  (*Info)->Version              = This->Mode->Info->Version;
-  (*Info)->HorizontalResolution = This->Mode->Info->HorizontalResolution;
-  (*Info)->VerticalResolution   = This->Mode->Info->VerticalResolution;
-  (*Info)->PixelFormat          = This->Mode->Info->PixelFormat;
-  (*Info)->PixelsPerScanLine    = This->Mode->Info->PixelsPerScanLine;
+  *SizeOfInfo = sizeof(EFI_GRAPHICS_OUTPUT_MODE_INFORMATION);
+  CopyMem(*Info, &mModeInfo[ModeNumber], *SizeOfInfo);
 
   return EFI_SUCCESS;
 }
@@ -114,6 +301,77 @@ EFI_STATUS
 EFIAPI
 DisplaySetMode(IN EFI_GRAPHICS_OUTPUT_PROTOCOL *This, IN UINT32 ModeNumber)
 {
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION BltInfo;
+  UINTN                                Scale;
+  UINTN                                ScaledSize = 0;
+  UINT32                              *ScaledBuffer = NULL;
+  UINT32                              *PreviousBuffer;
+  UINTN                                PreviousSize;
+  UINT32                              *Panel;
+  RETURN_STATUS                        Status;
+  EFI_TPL                              Tpl;
+
+  if (ModeNumber >= This->Mode->MaxMode)
+    return EFI_UNSUPPORTED;
+
+  Scale = mModeScale[ModeNumber];
+  if (Scale > 1) {
+    ScaledSize = mModeInfo[ModeNumber].PixelsPerScanLine *
+                 mModeInfo[ModeNumber].VerticalResolution * FB_BYTES_PER_PIXEL;
+    ScaledBuffer = AllocatePages(EFI_SIZE_TO_PAGES(ScaledSize));
+    if (ScaledBuffer == NULL)
+      return EFI_DEVICE_ERROR;
+    ZeroMem(ScaledBuffer, ScaledSize);
+  }
+
+  // Scaled modes are BltOnly to callers, but their buffer is plain BGRX
+  CopyMem(&BltInfo, &mModeInfo[ModeNumber], sizeof(BltInfo));
+  BltInfo.PixelFormat = PixelBlueGreenRedReserved8BitPerColor;
+
+  Panel = mShadowBuffer != NULL ? mShadowBuffer : mScanoutBuffer;
+
+  Tpl    = gBS->RaiseTPL(TPL_NOTIFY);
+  Status = FrameBufferBltConfigure(
+      ScaledBuffer != NULL ? (VOID *)ScaledBuffer : (VOID *)Panel, &BltInfo,
+      mFrameBufferBltLibConfigure, &mFrameBufferBltLibConfigureSize);
+  if (RETURN_ERROR(Status)) {
+    gBS->RestoreTPL(Tpl);
+    if (ScaledBuffer != NULL)
+      FreePages(ScaledBuffer, EFI_SIZE_TO_PAGES(ScaledSize));
+    return EFI_DEVICE_ERROR;
+  }
+
+  PreviousBuffer = mScaledBuffer;
+  PreviousSize   = This->Mode->Info->PixelsPerScanLine *
+                 This->Mode->Info->VerticalResolution * FB_BYTES_PER_PIXEL;
+  mScaledBuffer = ScaledBuffer;
+  mScale        = Scale;
+
+  This->Mode->Mode = ModeNumber;
+  CopyMem(This->Mode->Info, &mModeInfo[ModeNumber], sizeof(BltInfo));
+  This->Mode->FrameBufferBase = Scale > 1 ? 0 : (UINTN)mScanoutBuffer;
+  This->Mode->FrameBufferSize =
+      Scale > 1 ? 0
+                : mModeInfo[0].PixelsPerScanLine *
+                      mModeInfo[0].VerticalResolution * FB_BYTES_PER_PIXEL;
+
+  // A mode switch clears the screen
+  ZeroMem(
+      Panel, mModeInfo[0].PixelsPerScanLine * mModeInfo[0].VerticalResolution *
+                 FB_BYTES_PER_PIXEL);
+  if (mShadowBuffer != NULL)
+    DisplayAddDamage(
+        0, 0, mModeInfo[0].HorizontalResolution,
+        mModeInfo[0].VerticalResolution);
+  else
+    DisplayFlushRect(
+        0, 0, mModeInfo[0].HorizontalResolution,
+        mModeInfo[0].VerticalResolution);
+  gBS->RestoreTPL(Tpl);
+
+  if (PreviousBuffer != NULL)
+    FreePages(PreviousBuffer, EFI_SIZE_TO_PAGES(PreviousSize));
+
   return EFI_SUCCESS;
 }
 
@@ -131,6 +389,9 @@ DisplayBlt(
 
   RETURN_STATUS Status;
   EFI_TPL       Tpl;
+  BOOLEAN       Damaged;
+  UINT64        Start  = GetPerformanceCounter();
+  UINTN         Pixels = Width * Height;
   //
   // We have to raise to TPL_NOTIFY, so we make an atomic write to the frame
   // buffer. We would not want a timer based event (Cursor, ...) to come in
@@ -140,17 +401,106 @@ DisplayBlt(
   Status = FrameBufferBlt(
       mFrameBufferBltLibConfigure, BltBuffer, BltOperation, SourceX, SourceY,
       DestinationX, DestinationY, Width, Height, Delta);
+
+  // EfiBltVideoToBltBuffer only reads the framebuffer
+  Damaged = !RETURN_ERROR(Status) && BltOperation != EfiBltVideoToBltBuffer;
+
+  // Scaled modes Blt into their own buffer; carry the change to the panel
+  if (Damaged && mScale > 1) {
+    DisplayUpscale(DestinationX, DestinationY, Width, Height);
+    DestinationX *= mScale;
+    DestinationY *= mScale;
+    Width *= mScale;
+    Height *= mScale;
+  }
+
+  // Blts into the shadow buffer reach the panel on the next present
+  if (Damaged && mShadowBuffer != NULL)
+    DisplayAddDamage(DestinationX, DestinationY, Width, Height);
   gBS->RestoreTPL(Tpl);
 
-  // zhuowei: hack: flush the cache manually since my memory maps are still
-  // broken
-  WriteBackInvalidateDataCacheRange(
-      (void *)mDisplay.Mode->FrameBufferBase, mDisplay.Mode->FrameBufferSize);
-  // zhuowei: end hack
+  // The display controller does not snoop the CPU caches, so clean only the
+  // lines this Blt wrote.
+  if (Damaged && mShadowBuffer == NULL) {
+    DisplayFlushRect(DestinationX, DestinationY, Width, Height);
+  }
+
+  if (!RETURN_ERROR(Status)) {
+    mBltCalls[BltOperation]++;
+    mBltPixels[BltOperation] += Pixels;
+    mBltTicks[BltOperation] += GetPerformanceCounter() - Start;
+  }
 
   return RETURN_ERROR(Status) ? EFI_INVALID_PARAMETER : EFI_SUCCESS;
 }
 
+STATIC
+VOID
+EFIAPI
+DisplayConsoleFlush(IN EFI_EVENT Event, IN VOID *Context)
+{
+  SerialPortFlush();
+}
+
+STATIC
+VOID
+EFIAPI
+DisplayPresentEvent(IN EFI_EVENT Event, IN VOID *Context)
+{
+  DisplayPresent();
+}
+
+STATIC
+VOID
+EFIAPI
+DisplayExitBootServices(IN EFI_EVENT Event, IN VOID *Context)
+{
+  UINTN  Index;
+  UINT64 Nanoseconds;
+
+  // No pool frees here; just stop the timers and drain what is left
+  if (mConsoleFlushEvent != NULL)
+    gBS->SetTimer(mConsoleFlushEvent, TimerCancel, 0);
+  if (mPresentEvent != NULL)
+    gBS->SetTimer(mPresentEvent, TimerCancel, 0);
+  DisplayPresent();
+  SerialPortFlush();
+
+  // The panel already shows the upscaled image; hand the OS the real
+  // framebuffer rather than a BltOnly mode
+  if (mScale > 1) {
+    mDisplay.Mode->Mode = 0;
+    CopyMem(mDisplay.Mode->Info, &mModeInfo[0], sizeof(mModeInfo[0]));
+    mDisplay.Mode->FrameBufferBase = (UINTN)mScanoutBuffer;
+    mDisplay.Mode->FrameBufferSize = mModeInfo[0].PixelsPerScanLine *
+                                     mModeInfo[0].VerticalResolution *
+                                     FB_BYTES_PER_PIXEL;
+  }
+
+  DEBUG(
+      (EFI_D_INFO,
+       "SimpleFbDxe: %lu bytes of framebuffer cache maintenance this boot\n",
+       FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned));
+  DEBUG(
+      (EFI_D_INFO, "SimpleFbDxe: console drew %lu cells over %lu lines\n",
+       FBCON_SHARED_STATE_ADDRESS->CellsDrawn,
+       FBCON_SHARED_STATE_ADDRESS->LinesRendered));
+
+  // Lands in the persistent RAM log, so it can be read back after a reboot
+  for (Index = 0; Index < EfiGraphicsOutputBltOperationMax; Index++) {
+    if (mBltCalls[Index] == 0)
+      continue;
+
+    Nanoseconds = GetTimeInNanoSecond(mBltTicks[Index]);
+    DEBUG(
+        (EFI_D_INFO,
+         "SimpleFbDxe: Blt %a: %lu calls, %lu pixels, %lu us, %lu Mpixel/s\n",
+         mBltOperationName[Index], mBltCalls[Index], mBltPixels[Index],
+         Nanoseconds / 1000,
+         Nanoseconds != 0 ? mBltPixels[Index] * 1000 / Nanoseconds : 0));
+  }
+}
+
 EFI_STATUS
 EFIAPI
 SimpleFbDxeInitialize(
@@ -159,6 +509,8 @@ SimpleFbDxeInitialize(
 
   EFI_STATUS Status             = EFI_SUCCESS;
   EFI_HANDLE hUEFIDisplayHandle = NULL;
+  VOID      *BltTarget;
+  UINTN      Index;
 
   /* Retrieve simple frame buffer from pre-SEC bootloader */
   DEBUG(
@@ -201,7 +553,7 @@ SimpleFbDxeInitialize(
   }
 
   /* Set information */
-  mDisplay.Mode->MaxMode       = 1;
+  mDisplay.Mode->MaxMode       = ARRAY_SIZE(mModeScale);
   mDisplay.Mode->Mode          = 0;
   mDisplay.Mode->Info->Version = 0;
 
@@ -219,18 +571,48 @@ SimpleFbDxeInitialize(
   mDisplay.Mode->FrameBufferBase = FrameBufferAddress;
   mDisplay.Mode->FrameBufferSize = FrameBufferSize;
 
+  // Native mode, then the reduced ones; any border left by a resolution that
+  // does not divide evenly stays black
+  mScanoutBuffer = (UINT32 *)(UINTN)FrameBufferAddress;
+  for (Index = 0; Index < ARRAY_SIZE(mModeScale); Index++) {
+    CopyMem(&mModeInfo[Index], mDisplay.Mode->Info, sizeof(mModeInfo[Index]));
+    if (mModeScale[Index] == 1)
+      continue;
+
+    mModeInfo[Index].HorizontalResolution =
+        MipiFrameBufferWidth / mModeScale[Index];
+    mModeInfo[Index].VerticalResolution =
+        MipiFrameBufferHeight / mModeScale[Index];
+    mModeInfo[Index].PixelsPerScanLine =
+        mModeInfo[Index].HorizontalResolution;
+    mModeInfo[Index].PixelFormat = PixelBltOnly;
+  }
+
+  // The scanout buffer is mapped write-through; Blt into cached memory instead
+  // and copy only what changed. FrameBufferBase stays the scanout buffer.
+  if (FeaturePcdGet(PcdSimpleFbShadowBuffer)) {
+    mShadowBuffer = AllocatePages(EFI_SIZE_TO_PAGES(FrameBufferSize));
+    if (mShadowBuffer == NULL)
+      DEBUG(
+          (EFI_D_ERROR,
+           "SimpleFbDxe: No memory for the shadow buffer, drawing directly\n"));
+  }
+  BltTarget = mShadowBuffer != NULL
+                  ? (VOID *)mShadowBuffer
+                  : (VOID *)(UINTN)mDisplay.Mode->FrameBufferBase;
+
   //
   // Create the FrameBufferBltLib configuration.
   //
   Status = FrameBufferBltConfigure(
-      (VOID *)(UINTN)mDisplay.Mode->FrameBufferBase, mDisplay.Mode->Info,
-      mFrameBufferBltLibConfigure, &mFrameBufferBltLibConfigureSize);
+      BltTarget, mDisplay.Mode->Info, mFrameBufferBltLibConfigure,
+      &mFrameBufferBltLibConfigureSize);
   if (Status == RETURN_BUFFER_TOO_SMALL) {
     mFrameBufferBltLibConfigure = AllocatePool(mFrameBufferBltLibConfigureSize);
     if (mFrameBufferBltLibConfigure != NULL) {
       Status = FrameBufferBltConfigure(
-          (VOID *)(UINTN)mDisplay.Mode->FrameBufferBase, mDisplay.Mode->Info,
-          mFrameBufferBltLibConfigure, &mFrameBufferBltLibConfigureSize);
+          BltTarget, mDisplay.Mode->Info, mFrameBufferBltLibConfigure,
+          &mFrameBufferBltLibConfigureSize);
     }
   }
   ASSERT_EFI_ERROR(Status);
@@ -242,8 +624,14 @@ SimpleFbDxeInitialize(
   // hack: clear cache
   WriteBackInvalidateDataCacheRange(
       (void *)FrameBufferAddress, FrameBufferSize);
+  FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned += FrameBufferSize;
   // zhuowei: end
 
+  // Mode 0 starts out with what the panel shows, so Blt reads and partial
+  // presents see the same pixels as the scanout buffer
+  if (mShadowBuffer != NULL)
+    CopyMem(mShadowBuffer, (VOID *)(UINTN)FrameBufferAddress, FrameBufferSize);
+
   /* Register handle */
   Status = gBS->InstallMultipleProtocolInterfaces(
       &hUEFIDisplayHandle, &gEfiDevicePathProtocolGuid, &mDisplayDevicePath,
@@ -251,5 +639,23 @@ SimpleFbDxeInitialize(
 
   ASSERT_EFI_ERROR(Status);
 
+  // Render console output that does not end in a newline
+  if (!EFI_ERROR(gBS->CreateEvent(
+          EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK, DisplayConsoleFlush,
+          NULL, &mConsoleFlushEvent)))
+    gBS->SetTimer(mConsoleFlushEvent, TimerPeriodic, CONSOLE_FLUSH_PERIOD);
+
+  // Copy damaged parts of the shadow buffer to the panel
+  if (mShadowBuffer != NULL &&
+      !EFI_ERROR(gBS->CreateEvent(
+          EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK, DisplayPresentEvent,
+          NULL, &mPresentEvent)))
+    gBS->SetTimer(mPresentEvent, TimerPeriodic, SHADOW_PRESENT_PERIOD);
+
+  // Report the per-boot cache maintenance total in the debug log
+  gBS->CreateEventEx(
+      EVT_NOTIFY_SIGNAL, TPL_CALLBACK, DisplayExitBootServices, NULL,
+      &gEfiEventExitBootServicesGuid, &mExitBootServicesEvent);
+
   return Status;
 }
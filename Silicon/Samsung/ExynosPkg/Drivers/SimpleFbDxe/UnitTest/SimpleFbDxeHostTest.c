@@ -0,0 +1,509 @@
+/** @file
+  Host tests for SimpleFbDxe.
+
+  The driver is built into the test with a boot services table that only
+  does what SimpleFbDxeInitialize and the GOP functions need, and draws into
+  a framebuffer mapped where PcdMipiFrameBufferAddress points
+  (HostFrameBufferLib). Blts are checked against the golden images in
+  SimpleFbDxeHostTestGolden.h, in every mode, and against the cache
+  maintenance they should cause. The throughput case reports Mpixel/s for
+  each Blt operation, as the driver does at ExitBootServices.
+
+  SimpleFbDxeHostTest.inf builds the driver as it draws straight into the
+  framebuffer, SimpleFbDxeShadowHostTest.inf with PcdSimpleFbShadowBuffer
+  set. Both have to produce the same images.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "../SimpleFbDxe.c"
+
+#include <Library/HostCacheMaintenanceLib.h>
+#include <Library/HostFrameBufferLib.h>
+#include <Library/UnitTestLib.h>
+
+#include <Resources/FbColor.h>
+
+#include "SimpleFbDxeHostTestGolden.h"
+
+#define UNIT_TEST_APP_NAME    "SimpleFbDxe Host Tests"
+#define UNIT_TEST_APP_VERSION "1.0"
+
+#define PANEL_WIDTH  FixedPcdGet32(PcdMipiFrameBufferWidth)
+#define PANEL_HEIGHT FixedPcdGet32(PcdMipiFrameBufferHeight)
+
+// Full panel Blts per operation in the throughput case
+#define THROUGHPUT_BLTS 20
+
+#define BLT_PIXEL(Color)                                                       \
+  {(UINT8)(Color), (UINT8)((Color) >> 8), (UINT8)((Color) >> 16),             \
+   (UINT8)((Color) >> 24)}
+
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL mRed   = BLT_PIXEL(FB_BGRA8888_RED);
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL mCyan  = BLT_PIXEL(FB_BGRA8888_CYAN);
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL mWhite = BLT_PIXEL(FB_BGRA8888_WHITE);
+
+// A 4x4 sprite, as a BufferToVideo caller would pass it
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL mSprite[4 * 4] = {
+    BLT_PIXEL(FB_BGRA8888_GREEN), BLT_PIXEL(FB_BGRA8888_BLUE),
+    BLT_PIXEL(FB_BGRA8888_GREEN), BLT_PIXEL(FB_BGRA8888_BLUE),
+    BLT_PIXEL(FB_BGRA8888_BLUE),  BLT_PIXEL(FB_BGRA8888_YELLOW),
+    BLT_PIXEL(FB_BGRA8888_YELLOW), BLT_PIXEL(FB_BGRA8888_GREEN),
+    BLT_PIXEL(FB_BGRA8888_GREEN), BLT_PIXEL(FB_BGRA8888_YELLOW),
+    BLT_PIXEL(FB_BGRA8888_YELLOW), BLT_PIXEL(FB_BGRA8888_BLUE),
+    BLT_PIXEL(FB_BGRA8888_BLUE),  BLT_PIXEL(FB_BGRA8888_GREEN),
+    BLT_PIXEL(FB_BGRA8888_BLUE),  BLT_PIXEL(FB_BGRA8888_GREEN),
+};
+
+//
+// Boot services: TPL tracking, pool, and events that are never signalled
+//
+STATIC EFI_BOOT_SERVICES mBootServices;
+STATIC EFI_TPL           mTpl = TPL_APPLICATION;
+STATIC UINTN             mSerialPortFlushes;
+
+EFI_BOOT_SERVICES *gBS = &mBootServices;
+
+STATIC
+EFI_TPL
+EFIAPI
+HostRaiseTpl(IN EFI_TPL NewTpl)
+{
+  EFI_TPL OldTpl = mTpl;
+
+  ASSERT(NewTpl >= mTpl);
+  mTpl = NewTpl;
+  return OldTpl;
+}
+
+STATIC
+VOID
+EFIAPI
+HostRestoreTpl(IN EFI_TPL OldTpl)
+{
+  ASSERT(OldTpl <= mTpl);
+  mTpl = OldTpl;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostAllocatePool(
+    IN EFI_MEMORY_TYPE PoolType, IN UINTN Size, OUT VOID **Buffer)
+{
+  *Buffer = AllocatePool(Size);
+  return *Buffer != NULL ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostFreePool(IN VOID *Buffer)
+{
+  FreePool(Buffer);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCreateEvent(
+    IN UINT32 Type, IN EFI_TPL NotifyTpl, IN EFI_EVENT_NOTIFY NotifyFunction,
+    IN VOID *NotifyContext, OUT EFI_EVENT *Event)
+{
+  *Event = (EFI_EVENT)&mBootServices;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostCreateEventEx(
+    IN UINT32 Type, IN EFI_TPL NotifyTpl, IN EFI_EVENT_NOTIFY NotifyFunction,
+    IN CONST VOID *NotifyContext, IN CONST EFI_GUID *EventGroup,
+    OUT EFI_EVENT *Event)
+{
+  *Event = (EFI_EVENT)&mBootServices;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostSetTimer(IN EFI_EVENT Event, IN EFI_TIMER_DELAY Type, IN UINT64 Time)
+{
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+HostInstallMultipleProtocolInterfaces(IN OUT EFI_HANDLE *Handle, ...)
+{
+  *Handle = (EFI_HANDLE)&mDisplay;
+  return EFI_SUCCESS;
+}
+
+// FrameBufferSerialPortLib, called by the console flush timer
+UINTN
+SerialPortFlush(VOID)
+{
+  mSerialPortFlushes++;
+  return 0;
+}
+
+/**
+  What the panel shows once any pending shadow buffer damage is presented.
+**/
+STATIC
+BOOLEAN
+PanelMatches(
+    IN CONST CHAR8 *Name, IN UINTN Width, IN UINTN Height,
+    IN CONST CHAR8 *CONST *Golden)
+{
+  DisplayPresent();
+  return HostFrameBufferMatches(Name, 0, 0, Width, Height, Golden);
+}
+
+/**
+  Each case starts in mode 0 with a cleared panel and nothing counted.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetDisplay(IN UNIT_TEST_CONTEXT Context)
+{
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.SetMode(&mDisplay, 0));
+  DisplayPresent();
+  HostCacheMaintenanceReset();
+  ZeroMem(mBltCalls, sizeof(mBltCalls));
+  ZeroMem(mBltPixels, sizeof(mBltPixels));
+  ZeroMem(mBltTicks, sizeof(mBltTicks));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Before any SetMode, a Blt read returns what the panel shows, shadow buffer
+  or not.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InitialMode(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Buffer;
+  UINTN                          Size;
+  BOOLEAN                        Same;
+
+  UT_ASSERT_EQUAL(mDisplay.Mode->Mode, 0);
+
+  Size   = PANEL_WIDTH * PANEL_HEIGHT * sizeof(*Buffer);
+  Buffer = AllocatePool(Size);
+  UT_ASSERT_NOT_NULL(Buffer);
+  SetMem32(Buffer, Size, 0xFF204060);
+
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, Buffer, EfiBltVideoToBltBuffer, 0, 0, 0, 0, PANEL_WIDTH,
+      PANEL_HEIGHT, 0));
+  Same = CompareMem(Buffer, mScanoutBuffer, Size) == 0;
+  FreePool(Buffer);
+  UT_ASSERT_TRUE(Same);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fill, draw the sprite, copy both, and read the sprite back.
+**/
+STATIC
+UNIT_TEST_STATUS
+DrawScene(VOID)
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL ReadBack[4 * 4];
+
+  UT_ASSERT_NOT_EFI_ERROR(
+      mDisplay.Blt(&mDisplay, &mRed, EfiBltVideoFill, 0, 0, 1, 1, 6, 4, 0));
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, mSprite, EfiBltBufferToVideo, 0, 0, 2, 1, 4, 4, 0));
+  UT_ASSERT_NOT_EFI_ERROR(
+      mDisplay.Blt(&mDisplay, NULL, EfiBltVideoToVideo, 1, 1, 8, 3, 6, 4, 0));
+  UT_ASSERT_EQUAL(mTpl, TPL_APPLICATION);
+
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, ReadBack, EfiBltVideoToBltBuffer, 9, 3, 0, 0, 4, 4, 0));
+  UT_ASSERT_MEM_EQUAL(ReadBack, mSprite, sizeof(ReadBack));
+
+  //
+  // Blts that do not fit the mode are refused
+  //
+  UT_ASSERT_STATUS_EQUAL(
+      mDisplay.Blt(
+          &mDisplay, &mCyan, EfiBltVideoFill, 0, 0,
+          mDisplay.Mode->Info->HorizontalResolution - 1, 0, 2, 1, 0),
+      EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL(mTpl, TPL_APPLICATION);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BltOperations(IN UNIT_TEST_CONTEXT Context)
+{
+  UNIT_TEST_STATUS Status;
+
+  Status = DrawScene();
+  if (Status != UNIT_TEST_PASSED)
+    return Status;
+
+  UT_ASSERT_TRUE(PanelMatches("Native", 16, 8, mNative));
+  UT_ASSERT_EQUAL(mBltCalls[EfiBltVideoFill], 1);
+  UT_ASSERT_EQUAL(mBltPixels[EfiBltVideoFill], 6 * 4);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+ScaledModes(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *Info;
+  UINTN                                 SizeOfInfo;
+  UNIT_TEST_STATUS                      Status;
+
+  UT_ASSERT_EQUAL(mDisplay.Mode->MaxMode, 3);
+
+  //
+  // Mode 1 renders at half the panel resolution, with no framebuffer for
+  // the caller
+  //
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.QueryMode(&mDisplay, 1, &SizeOfInfo, &Info));
+  UT_ASSERT_EQUAL(Info->HorizontalResolution, PANEL_WIDTH / 2);
+  UT_ASSERT_EQUAL(Info->VerticalResolution, PANEL_HEIGHT / 2);
+  UT_ASSERT_EQUAL(Info->PixelFormat, PixelBltOnly);
+  FreePool(Info);
+
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.SetMode(&mDisplay, 1));
+  UT_ASSERT_EQUAL(mDisplay.Mode->FrameBufferBase, 0);
+  Status = DrawScene();
+  if (Status != UNIT_TEST_PASSED)
+    return Status;
+  UT_ASSERT_TRUE(PanelMatches("Scale2", 32, 16, mScale2));
+
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.SetMode(&mDisplay, 2));
+  Status = DrawScene();
+  if (Status != UNIT_TEST_PASSED)
+    return Status;
+  UT_ASSERT_TRUE(PanelMatches("Scale3", 48, 24, mScale3));
+
+  //
+  // Switching back clears the panel and hands out the framebuffer again
+  //
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.SetMode(&mDisplay, 0));
+  UT_ASSERT_EQUAL(
+      mDisplay.Mode->FrameBufferBase,
+      FixedPcdGet32(PcdMipiFrameBufferAddress));
+  DisplayPresent();
+  UT_ASSERT_EQUAL(HostFrameBufferCrc32(), CLEARED_FRAME_CRC32);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+FlushCoversBlt(IN UNIT_TEST_CONTEXT Context)
+{
+  HOST_CACHE_MAINTENANCE_STATS Stats;
+  UINT64                       Cleaned;
+  UINTN                        LineLength;
+
+  LineLength = PANEL_WIDTH * sizeof(UINT32);
+  Cleaned    = FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned;
+
+  //
+  // Narrow: each row's span. Wide: the whole band of rows.
+  //
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, &mWhite, EfiBltVideoFill, 0, 0, 100, 200, 10, 4, 0));
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, &mWhite, EfiBltVideoFill, 0, 0, 0, 300, PANEL_WIDTH / 2, 2,
+      0));
+
+  //
+  // The shadow buffer reaches the panel, and the cache, only when presented;
+  // the two rectangles are far apart so stay separate
+  //
+  HostCacheMaintenanceGetStats(&Stats);
+  if (FeaturePcdGet(PcdSimpleFbShadowBuffer)) {
+    UT_ASSERT_EQUAL(Stats.RangeCalls, 0);
+    UT_ASSERT_EQUAL(mDamageCount, 2);
+    DisplayPresent();
+    HostCacheMaintenanceGetStats(&Stats);
+  }
+
+  UT_ASSERT_EQUAL(Stats.RangeCalls, 4 + 1);
+  UT_ASSERT_EQUAL(Stats.RangeBytes, 4 * 10 * sizeof(UINT32) + 2 * LineLength);
+  UT_ASSERT_EQUAL(
+      FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned - Cleaned,
+      Stats.RangeBytes);
+  UT_ASSERT_EQUAL(
+      Stats.Lowest,
+      FixedPcdGet32(PcdMipiFrameBufferAddress) + 200 * LineLength +
+          100 * sizeof(UINT32));
+  UT_ASSERT_EQUAL(
+      Stats.Highest,
+      FixedPcdGet32(PcdMipiFrameBufferAddress) + 302 * LineLength);
+  UT_ASSERT_EQUAL(Stats.WholeCacheCalls, 0);
+
+  //
+  // Reading the framebuffer cleans nothing
+  //
+  HostCacheMaintenanceReset();
+  UT_ASSERT_NOT_EFI_ERROR(mDisplay.Blt(
+      &mDisplay, mSprite, EfiBltVideoToBltBuffer, 0, 0, 0, 0, 4, 4, 0));
+  DisplayPresent();
+  HostCacheMaintenanceGetStats(&Stats);
+  UT_ASSERT_EQUAL(Stats.RangeCalls, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+BltThroughput(IN UNIT_TEST_CONTEXT Context)
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Buffer;
+  UINTN                          Index;
+  UINT64                         Start;
+  UINT64                         PresentTicks;
+
+  Buffer = AllocatePool(PANEL_WIDTH * PANEL_HEIGHT * sizeof(*Buffer));
+  UT_ASSERT_NOT_NULL(Buffer);
+  SetMem32(Buffer, PANEL_WIDTH * PANEL_HEIGHT * sizeof(*Buffer), 0xFF204060);
+
+  //
+  // Full panel Blts of each kind; a screen's worth of scrolling for
+  // VideoToVideo
+  //
+  PresentTicks = 0;
+  for (Index = 0; Index < THROUGHPUT_BLTS; Index++) {
+    mDisplay.Blt(
+        &mDisplay, &mCyan, EfiBltVideoFill, 0, 0, 0, 0, PANEL_WIDTH,
+        PANEL_HEIGHT, 0);
+    mDisplay.Blt(
+        &mDisplay, Buffer, EfiBltBufferToVideo, 0, 0, 0, 0, PANEL_WIDTH,
+        PANEL_HEIGHT, 0);
+    mDisplay.Blt(
+        &mDisplay, Buffer, EfiBltVideoToBltBuffer, 0, 0, 0, 0, PANEL_WIDTH,
+        PANEL_HEIGHT, 0);
+    mDisplay.Blt(
+        &mDisplay, NULL, EfiBltVideoToVideo, 0, 24, 0, 0, PANEL_WIDTH,
+        PANEL_HEIGHT - 24, 0);
+
+    Start = GetPerformanceCounter();
+    DisplayPresent();
+    PresentTicks += GetPerformanceCounter() - Start;
+  }
+
+  FreePool(Buffer);
+
+  for (Index = 0; Index < EfiGraphicsOutputBltOperationMax; Index++)
+    UT_ASSERT_EQUAL(mBltCalls[Index], THROUGHPUT_BLTS);
+
+  //
+  // The driver's own report, as it lands in the log at ExitBootServices
+  //
+  DisplayExitBootServices(NULL, NULL);
+  if (FeaturePcdGet(PcdSimpleFbShadowBuffer))
+    DEBUG(
+        (DEBUG_INFO, "SimpleFbDxe: present: %lu frames, %lu us\n",
+         (UINT64)THROUGHPUT_BLTS, GetTimeInNanoSecond(PresentTicks) / 1000));
+
+  return UNIT_TEST_PASSED;
+}
+
+EFI_STATUS
+EFIAPI
+UefiTestMain(VOID)
+{
+  EFI_STATUS                 Status;
+  UNIT_TEST_FRAMEWORK_HANDLE Framework;
+  UNIT_TEST_SUITE_HANDLE     Suite;
+
+  Framework = NULL;
+
+  DEBUG((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  if (HostFrameBufferMap() == NULL) {
+    DEBUG((DEBUG_ERROR, "Cannot map the framebuffer\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mBootServices.RaiseTPL       = HostRaiseTpl;
+  mBootServices.RestoreTPL     = HostRestoreTpl;
+  mBootServices.AllocatePool   = HostAllocatePool;
+  mBootServices.FreePool       = HostFreePool;
+  mBootServices.CreateEvent    = HostCreateEvent;
+  mBootServices.CreateEventEx  = HostCreateEventEx;
+  mBootServices.SetTimer       = HostSetTimer;
+  mBootServices.InstallMultipleProtocolInterfaces =
+      HostInstallMultipleProtocolInterfaces;
+
+  Status = SimpleFbDxeInitialize(NULL, NULL);
+  if (EFI_ERROR(Status)) {
+    DEBUG(
+        (DEBUG_ERROR, "Failed in SimpleFbDxeInitialize. Status = %r\n",
+         Status));
+    goto EXIT;
+  }
+
+  Status = InitUnitTestFramework(
+      &Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName,
+      UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR(Status)) {
+    DEBUG(
+        (DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n",
+         Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite(
+      &Suite, Framework, "Simple framebuffer GOP", "ExynosPkg.SimpleFbDxe",
+      NULL, NULL);
+  if (EFI_ERROR(Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase(
+      Suite, "The initial mode reads back the panel", "InitialMode",
+      InitialMode, NULL, NULL, NULL);
+  AddTestCase(
+      Suite, "Blts in the native mode", "BltOperations", BltOperations,
+      ResetDisplay, NULL, NULL);
+  AddTestCase(
+      Suite, "Blts in the scaled modes", "ScaledModes", ScaledModes,
+      ResetDisplay, NULL, NULL);
+  AddTestCase(
+      Suite, "Only what a Blt wrote is cleaned", "FlushCoversBlt",
+      FlushCoversBlt, ResetDisplay, NULL, NULL);
+  AddTestCase(
+      Suite, "Mpixel/s per Blt operation", "BltThroughput", BltThroughput,
+      ResetDisplay, NULL, NULL);
+
+  Status = RunAllTestSuites(Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework(Framework);
+  }
+
+  HostFrameBufferUnmap();
+  return Status;
+}
+
+int
+main(int argc, char *argv[])
+{
+  return UefiTestMain();
+}
@@ -0,0 +1,75 @@
+/** @file
+  Golden images of SimpleFbDxeHostTest.c, in the format HostFrameBufferLib.h
+  describes. Produced by running the driver and checked by eye; a failing case
+  prints its image in the same form.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _SIMPLE_FB_DXE_HOST_TEST_GOLDEN_H_
+#define _SIMPLE_FB_DXE_HOST_TEST_GOLDEN_H_
+
+// Mode 0: a red fill, the sprite drawn over it, and both copied
+STATIC CONST CHAR8 *CONST mNative[] = {
+    "                ",
+    " RGBGBR         ",
+    " RBYYGR         ",
+    " RGYYBR RGBGBR  ",
+    " RBGBGR RBYYGR  ",
+    "        RGYYBR  ",
+    "        RBGBGR  ",
+    "                ",
+};
+
+// The same Blts in mode 1, widened to the panel
+STATIC CONST CHAR8 *CONST mScale2[] = {
+    "                                ",
+    "                                ",
+    "  RRGGBBGGBBRR                  ",
+    "  RRGGBBGGBBRR                  ",
+    "  RRBBYYYYGGRR                  ",
+    "  RRBBYYYYGGRR                  ",
+    "  RRGGYYYYBBRR  RRGGBBGGBBRR    ",
+    "  RRGGYYYYBBRR  RRGGBBGGBBRR    ",
+    "  RRBBGGBBGGRR  RRBBYYYYGGRR    ",
+    "  RRBBGGBBGGRR  RRBBYYYYGGRR    ",
+    "                RRGGYYYYBBRR    ",
+    "                RRGGYYYYBBRR    ",
+    "                RRBBGGBBGGRR    ",
+    "                RRBBGGBBGGRR    ",
+    "                                ",
+    "                                ",
+};
+
+// The same Blts in mode 2
+STATIC CONST CHAR8 *CONST mScale3[] = {
+    "                                                ",
+    "                                                ",
+    "                                                ",
+    "   RRRGGGBBBGGGBBBRRR                           ",
+    "   RRRGGGBBBGGGBBBRRR                           ",
+    "   RRRGGGBBBGGGBBBRRR                           ",
+    "   RRRBBBYYYYYYGGGRRR                           ",
+    "   RRRBBBYYYYYYGGGRRR                           ",
+    "   RRRBBBYYYYYYGGGRRR                           ",
+    "   RRRGGGYYYYYYBBBRRR   RRRGGGBBBGGGBBBRRR      ",
+    "   RRRGGGYYYYYYBBBRRR   RRRGGGBBBGGGBBBRRR      ",
+    "   RRRGGGYYYYYYBBBRRR   RRRGGGBBBGGGBBBRRR      ",
+    "   RRRBBBGGGBBBGGGRRR   RRRBBBYYYYYYGGGRRR      ",
+    "   RRRBBBGGGBBBGGGRRR   RRRBBBYYYYYYGGGRRR      ",
+    "   RRRBBBGGGBBBGGGRRR   RRRBBBYYYYYYGGGRRR      ",
+    "                        RRRGGGYYYYYYBBBRRR      ",
+    "                        RRRGGGYYYYYYBBBRRR      ",
+    "                        RRRGGGYYYYYYBBBRRR      ",
+    "                        RRRBBBGGGBBBGGGRRR      ",
+    "                        RRRBBBGGGBBBGGGRRR      ",
+    "                        RRRBBBGGGBBBGGGRRR      ",
+    "                                                ",
+    "                                                ",
+    "                                                ",
+};
+
+// CalculateCrc32 of the whole panel after a mode switch
+#define CLEARED_FRAME_CRC32 0xD1B3C18DU
+
+#endif
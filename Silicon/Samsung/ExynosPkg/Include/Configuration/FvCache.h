@@ -0,0 +1,60 @@
+#ifndef __FV_CACHE_H__
+#define __FV_CACHE_H__
+
+//
+// Copy of the FV DecompressFirstFv extracted, kept in a reserved RAM region
+// (PcdFvCacheBase/PcdFvCacheSize) that survives warm resets. PrePi
+// publishes it instead of decompressing again when it matches the digest
+// the FD carries for it. Off unless PcdFvCacheEnable is set (build.sh
+// --fv-cache).
+//
+// Trust model: the FD is trusted, it is the code that is running. The
+// region is not: the OS and anything else that ran since the last boot can
+// write it, and a warm reset keeps whatever they left there. So nothing in
+// the region vouches for the FV. The header CRC only catches a cold boot or
+// a torn save. The FV is used only if its SHA-256 equals the one
+// tools/FvCacheDigest computed from FVMAIN at build time and stamped into
+// the FV_CACHE_DIGEST_FILE_GUID file of FVMAIN_COMPACT. Getting another FV
+// accepted takes a SHA-256 second preimage, or a firmware that was built
+// with that FV anyway.
+//
+// Not covered: the FV is hashed in place and then used, so a bus master
+// the previous OS left running across the warm reset could still change it
+// after the check. Leave the cache off on platforms where the bootloader
+// does not quiesce DMA on a warm reset.
+//
+#define FV_CACHE_SIGNATURE SIGNATURE_64('E', 'X', 'Y', 'N', 'F', 'V', 'C', 'A')
+
+// The FV starts this far into the region, enough for any FvAlignment the
+// FDFs use
+#define FV_CACHE_DATA_OFFSET SIZE_64KB
+
+// SHA256_DIGEST_SIZE
+#define FV_CACHE_DIGEST_SIZE 32
+
+// FREEFORM file in FVMAIN_COMPACT holding the SHA-256 of FVMAIN. The FDFs
+// put FvCacheDigest.bin, all zeros, there and build.sh stamps the digest in.
+#define FV_CACHE_DIGEST_FILE_GUID                                              \
+  {                                                                            \
+    0x5e5e7c1a, 0x48b8, 0x4860,                                                \
+    {                                                                          \
+      0xa3, 0xbc, 0xdd, 0xd6, 0x88, 0x7a, 0x2c, 0x46                           \
+    }                                                                          \
+  }
+
+typedef struct _FV_CACHE_HEADER {
+  UINT64   Signature;
+  // CalculateCrc32 of this header with HeaderCrc set to 0
+  UINT32   HeaderCrc;
+  UINT32   Reserved;
+  UINT64   FvLength;
+  // The FD digest when the FV was saved, a different one means new firmware
+  UINT8    Digest[FV_CACHE_DIGEST_SIZE];
+  // What DecompressFirstFv put in the FV2 HOB
+  EFI_GUID FvName;
+  EFI_GUID FileName;
+} FV_CACHE_HEADER, *PFV_CACHE_HEADER;
+
+#define FV_CACHE_DATA(Cache) ((UINT8 *)(Cache) + FV_CACHE_DATA_OFFSET)
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __PERSISTENT_LOG_H__
+#define __PERSISTENT_LOG_H__
+
+//
+// Console log kept in a reserved, write-through RAM region
+// (PcdPersistentLogBase/PcdPersistentLogSize) that survives warm resets,
+// e.g. the one issued by Reboot2PayloadApp. Each boot appends to the same
+// ring after a "--- boot N ---" marker. Dump it from the Shell with
+// "dmem <base> <size>", or from Linux through /dev/mem: the region is
+// reported as reserved memory.
+//
+#define PERSISTENT_LOG_SIGNATURE SIGNATURE_64('E', 'X', 'Y', 'N', 'P', 'L', 'O', 'G')
+
+typedef struct _PERSISTENT_LOG_HEADER {
+  UINT64 Signature;
+  // CalculateCrc32 of this header with HeaderCrc set to 0
+  UINT32 HeaderCrc;
+  // Bytes of log data following the header
+  UINT32 Size;
+  // Boots logged since the ring was last reset
+  UINT32 BootCount;
+  UINT32 Reserved;
+  // Free-running byte counts; the oldest byte kept is Data[Tail % Size]
+  // and the next one written is Data[Head % Size]
+  UINT64 Head;
+  UINT64 Tail;
+  // Head when the current boot started
+  UINT64 BootStart;
+} PERSISTENT_LOG_HEADER, *PPERSISTENT_LOG_HEADER;
+
+#define PERSISTENT_LOG_DATA(Log) ((CHAR8 *)((PPERSISTENT_LOG_HEADER)(Log) + 1))
+
+#endif
@@ -11,6 +11,46 @@ typedef struct _FBCON_COLOR {
   UINTN Background;
 } FBCON_COLOR, *PFBCON_COLOR;
 
+// Console output queued by SerialPortWrite and not yet rendered
+#define FBCON_RING_SIZE 4096
+
+typedef struct _FBCON_CELL {
+  CHAR8 Char;
+  UINT8 Attribute;
+} FBCON_CELL, *PFBCON_CELL;
+
+// Console state shared between modules, stored in the reserved
+// PcdFbConStateBase region and cleared by InitializeSharedUartBuffers in
+// PlatformPrePiLib.
+typedef struct _FBCON_SHARED_STATE {
+  // Cursor, in text cells
+  INTN   PositionX;
+  INTN   PositionY;
+  // Bytes of framebuffer cache maintenance done this boot (FbCon + GOP)
+  UINT64 CacheBytesCleaned;
+  // Glyph cells drawn (including repaints) and lines ended this boot
+  UINT64 CellsDrawn;
+  UINT64 LinesRendered;
+  // Text-cell grid geometry; zero until the first character is written.
+  // Two Columns * Rows grids of FBCON_CELL follow this header: the console
+  // text, then the cells currently drawn on screen.
+  UINT32 Columns;
+  UINT32 Rows;
+  // Free-running indices into Ring; RingHead - RingTail bytes are pending
+  UINT32 RingHead;
+  UINT32 RingTail;
+  CHAR8  Ring[FBCON_RING_SIZE];
+} FBCON_SHARED_STATE, *PFBCON_SHARED_STATE;
+
+#define FBCON_SHARED_STATE_ADDRESS                                             \
+  ((PFBCON_SHARED_STATE)(UINTN)FixedPcdGet64(PcdFbConStateBase))
+
+// Bytes of the shared state with a Columns * Rows grid
+#define FBCON_SHARED_STATE_SIZE(Columns, Rows)                                 \
+  (sizeof(FBCON_SHARED_STATE) + 2 * (Columns) * (Rows) * sizeof(FBCON_CELL))
+
+#define FBCON_SHARED_CELLS(State) ((PFBCON_CELL)((PFBCON_SHARED_STATE)(State) + 1))
+
 enum FbConMsgType {
   /* type for menu */
   FBCON_COMMON_MSG = 0,
@@ -30,6 +70,15 @@ enum FbConMsgType {
 
 void ResetFb(void);
 
+// Renders all queued console output; returns the number of bytes rendered
+UINTN SerialPortFlush(VOID);
+
+// Persistent RAM log (Configuration/PersistentLog.h). PrePi calls
+// PersistentLogInitialize once per boot; every console write is appended.
+BOOLEAN PersistentLogEnabled(VOID);
+VOID    PersistentLogInitialize(VOID);
+VOID    PersistentLogAppend(IN CONST UINT8 *Buffer, IN UINTN NumberOfBytes);
+
 UINTN
 EFIAPI
 SerialPortWriteCritical(IN UINT8 *Buffer, IN UINTN NumberOfBytes);
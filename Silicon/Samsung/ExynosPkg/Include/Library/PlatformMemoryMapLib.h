@@ -62,4 +62,7 @@ typedef struct {
 
 ARM_MEMORY_REGION_DESCRIPTOR_EX* GetPlatformMemoryMap();
 
+/* MPIDR affinity of every core the SoC has, for PsciMpServicesDxe */
+UINT64* GetPlatformCoreMap(UINTN *CoreCount);
+
 #endif /* _PLATFORM_MEMORY_MAP_LIB_H_ */
\ No newline at end of file
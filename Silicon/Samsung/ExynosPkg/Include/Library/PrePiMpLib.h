@@ -0,0 +1,20 @@
+#ifndef _PREPI_MP_LIB_H_
+#define _PREPI_MP_LIB_H_
+
+// One piece of a job, called once for every Index below the job's Count.
+// Runs on any core, possibly with the MMU off, and must not print.
+typedef VOID (EFIAPI *PREPI_MP_JOB)(IN VOID *Context, IN UINTN Index);
+
+// Runs Job over [0, Count) on the boot core and the secondary cores PSCI
+// powers on for it, and returns once every piece is done. The secondaries
+// power themselves off again afterwards.
+VOID EFIAPI PrePiMpRun(IN PREPI_MP_JOB Job, IN VOID *Context, IN UINTN Count);
+
+// ZeroMem, split across cores
+VOID EFIAPI PrePiMpZeroMem(OUT VOID *Buffer, IN UINTN Length);
+
+// Waits for every secondary core to be off and logs what ran in parallel.
+// Call before leaving PrePi.
+VOID EFIAPI PrePiMpPark(VOID);
+
+#endif /* _PREPI_MP_LIB_H_ */
@@ -0,0 +1,448 @@
+/** @file
+  BaseMemoryLib for Exynos.
+
+  Once the MMU and data cache are enabled, large copies and fills go through
+  the NEON loops in AArch64/MemLibNeon.S and large zero fills use DC ZVA.
+  Before that (PrePi up to MemoryPeim) data accesses are Device-nGnRnE, so
+  only naturally aligned 64-bit and byte accesses are used.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "MemLibInternals.h"
+
+#define BYTE_PATTERN_64 0x0101010101010101ULL
+
+STATIC
+BOOLEAN
+IsCacheEnabled(IN UINTN Sctlr)
+{
+  return (Sctlr & (SCTLR_M | SCTLR_C)) == (SCTLR_M | SCTLR_C);
+}
+
+/**
+  Copies with 64-bit accesses when Destination and Source are mutually
+  aligned, bytes otherwise. Safe with the MMU off.
+**/
+STATIC
+VOID *
+InternalCopyMemAligned(
+    OUT VOID *DestinationBuffer, IN CONST VOID *SourceBuffer, IN UINTN Length)
+{
+  volatile UINT8  *Destination8;
+  CONST UINT8     *Source8;
+  volatile UINT64 *Destination64;
+  CONST UINT64    *Source64;
+  BOOLEAN          Wide;
+
+  Wide = (((UINTN)DestinationBuffer ^ (UINTN)SourceBuffer) &
+          (sizeof(UINT64) - 1)) == 0;
+
+  if (SourceBuffer > DestinationBuffer ||
+      (CONST UINT8 *)SourceBuffer + Length <= (UINT8 *)DestinationBuffer) {
+    Destination8 = DestinationBuffer;
+    Source8      = SourceBuffer;
+
+    if (Wide) {
+      while (Length > 0 &&
+             ((UINTN)Destination8 & (sizeof(UINT64) - 1)) != 0) {
+        *(Destination8++) = *(Source8++);
+        Length--;
+      }
+
+      Destination64 = (volatile UINT64 *)Destination8;
+      Source64      = (CONST UINT64 *)Source8;
+      while (Length >= sizeof(UINT64)) {
+        *(Destination64++) = *(Source64++);
+        Length -= sizeof(UINT64);
+      }
+
+      Destination8 = (volatile UINT8 *)Destination64;
+      Source8      = (CONST UINT8 *)Source64;
+    }
+
+    while (Length-- != 0)
+      *(Destination8++) = *(Source8++);
+  }
+  else {
+    Destination8 = (UINT8 *)DestinationBuffer + Length;
+    Source8      = (CONST UINT8 *)SourceBuffer + Length;
+
+    if (Wide) {
+      while (Length > 0 &&
+             ((UINTN)Destination8 & (sizeof(UINT64) - 1)) != 0) {
+        *(--Destination8) = *(--Source8);
+        Length--;
+      }
+
+      Destination64 = (volatile UINT64 *)Destination8;
+      Source64      = (CONST UINT64 *)Source8;
+      while (Length >= sizeof(UINT64)) {
+        *(--Destination64) = *(--Source64);
+        Length -= sizeof(UINT64);
+      }
+
+      Destination8 = (volatile UINT8 *)Destination64;
+      Source8      = (CONST UINT8 *)Source64;
+    }
+
+    while (Length-- != 0)
+      *(--Destination8) = *(--Source8);
+  }
+
+  return DestinationBuffer;
+}
+
+/**
+  Fills Buffer with a pattern that repeats every 8 bytes, using aligned
+  64-bit stores for the body. Buffer must be aligned to the pattern's
+  element size. Safe with the MMU off.
+**/
+STATIC
+VOID *
+InternalSetMemPattern(OUT VOID *Buffer, IN UINTN Length, IN UINT64 Pattern)
+{
+  volatile UINT8  *Pointer8;
+  volatile UINT64 *Pointer64;
+
+  Pointer8 = Buffer;
+  while (Length > 0 && ((UINTN)Pointer8 & (sizeof(UINT64) - 1)) != 0) {
+    *Pointer8 = (UINT8)(Pattern >> (((UINTN)Pointer8 & 7) * 8));
+    Pointer8++;
+    Length--;
+  }
+
+  Pointer64 = (volatile UINT64 *)Pointer8;
+  while (Length >= sizeof(UINT64)) {
+    *(Pointer64++) = Pattern;
+    Length -= sizeof(UINT64);
+  }
+
+  Pointer8 = (volatile UINT8 *)Pointer64;
+  while (Length-- != 0) {
+    *Pointer8 = (UINT8)(Pattern >> (((UINTN)Pointer8 & 7) * 8));
+    Pointer8++;
+  }
+
+  return Buffer;
+}
+
+VOID *
+EFIAPI
+CopyMem(
+    OUT VOID *DestinationBuffer, IN CONST VOID *SourceBuffer, IN UINTN Length)
+{
+  UINTN Sctlr;
+
+  if (Length == 0)
+    return DestinationBuffer;
+
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)DestinationBuffer));
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)SourceBuffer));
+
+  if (DestinationBuffer == SourceBuffer)
+    return DestinationBuffer;
+
+  if (Length >= EXYNOS_MEM_NEON_THRESHOLD) {
+    Sctlr = ExynosMemReadSctlr();
+    // With alignment checking on, the q register accesses need Source to
+    // line up once the destination is 16-byte aligned.
+    if (IsCacheEnabled(Sctlr) &&
+        ((Sctlr & SCTLR_A) == 0 ||
+         (((UINTN)DestinationBuffer ^ (UINTN)SourceBuffer) & 15) == 0))
+      return ExynosMemCopyNeon(DestinationBuffer, SourceBuffer, Length);
+  }
+
+  return InternalCopyMemAligned(DestinationBuffer, SourceBuffer, Length);
+}
+
+VOID *
+EFIAPI
+ZeroMem(OUT VOID *Buffer, IN UINTN Length)
+{
+  UINTN Dczid;
+  UINTN BlockSize;
+
+  if (Length == 0)
+    return Buffer;
+
+  ASSERT(Buffer != NULL);
+  ASSERT(Length <= (MAX_ADDRESS - (UINTN)Buffer + 1));
+
+  if (Length < EXYNOS_MEM_NEON_THRESHOLD ||
+      !IsCacheEnabled(ExynosMemReadSctlr()))
+    return InternalSetMemPattern(Buffer, Length, 0);
+
+  Dczid     = ExynosMemReadDczid();
+  BlockSize = 4 << (Dczid & DCZID_BS_MASK);
+  if ((Dczid & DCZID_DZP) == 0 && BlockSize >= 16 && Length >= 2 * BlockSize)
+    return ExynosMemZeroZva(Buffer, Length, BlockSize);
+
+  return ExynosMemSetNeon(Buffer, Length, 0);
+}
+
+VOID *
+EFIAPI
+SetMem(OUT VOID *Buffer, IN UINTN Length, IN UINT8 Value)
+{
+  if (Length == 0)
+    return Buffer;
+
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+
+  if (Value == 0)
+    return ZeroMem(Buffer, Length);
+
+  if (Length >= EXYNOS_MEM_NEON_THRESHOLD &&
+      IsCacheEnabled(ExynosMemReadSctlr()))
+    return ExynosMemSetNeon(Buffer, Length, Value);
+
+  return InternalSetMemPattern(Buffer, Length, Value * BYTE_PATTERN_64);
+}
+
+VOID *
+EFIAPI
+SetMem16(OUT VOID *Buffer, IN UINTN Length, IN UINT16 Value)
+{
+  if (Length == 0)
+    return Buffer;
+
+  ASSERT(Buffer != NULL);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((((UINTN)Buffer) & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  return InternalSetMemPattern(
+      Buffer, Length, Value * 0x0001000100010001ULL);
+}
+
+VOID *
+EFIAPI
+SetMem32(OUT VOID *Buffer, IN UINTN Length, IN UINT32 Value)
+{
+  if (Length == 0)
+    return Buffer;
+
+  ASSERT(Buffer != NULL);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((((UINTN)Buffer) & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  return InternalSetMemPattern(
+      Buffer, Length, Value * 0x0000000100000001ULL);
+}
+
+VOID *
+EFIAPI
+SetMem64(OUT VOID *Buffer, IN UINTN Length, IN UINT64 Value)
+{
+  if (Length == 0)
+    return Buffer;
+
+  ASSERT(Buffer != NULL);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((((UINTN)Buffer) & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  return InternalSetMemPattern(Buffer, Length, Value);
+}
+
+VOID *
+EFIAPI
+SetMemN(OUT VOID *Buffer, IN UINTN Length, IN UINTN Value)
+{
+  if (sizeof(UINTN) == sizeof(UINT64))
+    return SetMem64(Buffer, Length, (UINT64)Value);
+
+  return SetMem32(Buffer, Length, (UINT32)Value);
+}
+
+INTN
+EFIAPI
+CompareMem(
+    IN CONST VOID *DestinationBuffer, IN CONST VOID *SourceBuffer,
+    IN UINTN Length)
+{
+  CONST UINT8 *Destination8;
+  CONST UINT8 *Source8;
+
+  if (Length == 0 || DestinationBuffer == SourceBuffer)
+    return 0;
+
+  ASSERT(DestinationBuffer != NULL);
+  ASSERT(SourceBuffer != NULL);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)DestinationBuffer));
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)SourceBuffer));
+
+  Destination8 = DestinationBuffer;
+  Source8      = SourceBuffer;
+  while (--Length != 0 && *Destination8 == *Source8) {
+    Destination8++;
+    Source8++;
+  }
+
+  return (INTN)*Destination8 - (INTN)*Source8;
+}
+
+VOID *
+EFIAPI
+ScanMem8(IN CONST VOID *Buffer, IN UINTN Length, IN UINT8 Value)
+{
+  CONST UINT8 *Pointer;
+
+  if (Length == 0)
+    return NULL;
+
+  ASSERT(Buffer != NULL);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+
+  for (Pointer = Buffer; Length-- != 0; Pointer++) {
+    if (*Pointer == Value)
+      return (VOID *)Pointer;
+  }
+
+  return NULL;
+}
+
+VOID *
+EFIAPI
+ScanMem16(IN CONST VOID *Buffer, IN UINTN Length, IN UINT16 Value)
+{
+  CONST UINT16 *Pointer;
+
+  if (Length == 0)
+    return NULL;
+
+  ASSERT(Buffer != NULL);
+  ASSERT(((UINTN)Buffer & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  for (Pointer = Buffer; Length != 0; Pointer++, Length -= sizeof(Value)) {
+    if (*Pointer == Value)
+      return (VOID *)Pointer;
+  }
+
+  return NULL;
+}
+
+VOID *
+EFIAPI
+ScanMem32(IN CONST VOID *Buffer, IN UINTN Length, IN UINT32 Value)
+{
+  CONST UINT32 *Pointer;
+
+  if (Length == 0)
+    return NULL;
+
+  ASSERT(Buffer != NULL);
+  ASSERT(((UINTN)Buffer & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  for (Pointer = Buffer; Length != 0; Pointer++, Length -= sizeof(Value)) {
+    if (*Pointer == Value)
+      return (VOID *)Pointer;
+  }
+
+  return NULL;
+}
+
+VOID *
+EFIAPI
+ScanMem64(IN CONST VOID *Buffer, IN UINTN Length, IN UINT64 Value)
+{
+  CONST UINT64 *Pointer;
+
+  if (Length == 0)
+    return NULL;
+
+  ASSERT(Buffer != NULL);
+  ASSERT(((UINTN)Buffer & (sizeof(Value) - 1)) == 0);
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+  ASSERT((Length & (sizeof(Value) - 1)) == 0);
+
+  for (Pointer = Buffer; Length != 0; Pointer++, Length -= sizeof(Value)) {
+    if (*Pointer == Value)
+      return (VOID *)Pointer;
+  }
+
+  return NULL;
+}
+
+VOID *
+EFIAPI
+ScanMemN(IN CONST VOID *Buffer, IN UINTN Length, IN UINTN Value)
+{
+  if (sizeof(UINTN) == sizeof(UINT64))
+    return ScanMem64(Buffer, Length, (UINT64)Value);
+
+  return ScanMem32(Buffer, Length, (UINT32)Value);
+}
+
+GUID *
+EFIAPI
+CopyGuid(OUT GUID *DestinationGuid, IN CONST GUID *SourceGuid)
+{
+  WriteUnaligned64(
+      (UINT64 *)DestinationGuid, ReadUnaligned64((CONST UINT64 *)SourceGuid));
+  WriteUnaligned64(
+      (UINT64 *)DestinationGuid + 1,
+      ReadUnaligned64((CONST UINT64 *)SourceGuid + 1));
+
+  return DestinationGuid;
+}
+
+BOOLEAN
+EFIAPI
+CompareGuid(IN CONST GUID *Guid1, IN CONST GUID *Guid2)
+{
+  return ReadUnaligned64((CONST UINT64 *)Guid1) ==
+             ReadUnaligned64((CONST UINT64 *)Guid2) &&
+         ReadUnaligned64((CONST UINT64 *)Guid1 + 1) ==
+             ReadUnaligned64((CONST UINT64 *)Guid2 + 1);
+}
+
+VOID *
+EFIAPI
+ScanGuid(IN CONST VOID *Buffer, IN UINTN Length, IN CONST GUID *Guid)
+{
+  CONST GUID *GuidPtr;
+
+  ASSERT(((UINTN)Buffer & (sizeof(Guid->Data1) - 1)) == 0);
+  ASSERT(Length <= (MAX_ADDRESS - (UINTN)Buffer + 1));
+  ASSERT((Length & (sizeof(*GuidPtr) - 1)) == 0);
+
+  for (GuidPtr = Buffer; (UINTN)(GuidPtr + 1) <= (UINTN)Buffer + Length;
+       GuidPtr++) {
+    if (CompareGuid(GuidPtr, Guid))
+      return (VOID *)GuidPtr;
+  }
+
+  return NULL;
+}
+
+BOOLEAN
+EFIAPI
+IsZeroGuid(IN CONST GUID *Guid)
+{
+  return ReadUnaligned64((CONST UINT64 *)Guid) == 0 &&
+         ReadUnaligned64((CONST UINT64 *)Guid + 1) == 0;
+}
+
+BOOLEAN
+EFIAPI
+IsZeroBuffer(IN CONST VOID *Buffer, IN UINTN Length)
+{
+  CONST UINT8 *Pointer;
+
+  ASSERT(!(Buffer == NULL && Length > 0));
+  ASSERT((Length - 1) <= (MAX_ADDRESS - (UINTN)Buffer));
+
+  for (Pointer = Buffer; Length-- != 0; Pointer++) {
+    if (*Pointer != 0)
+      return FALSE;
+  }
+
+  return TRUE;
+}
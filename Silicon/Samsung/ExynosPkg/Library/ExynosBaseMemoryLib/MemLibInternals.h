@@ -0,0 +1,46 @@
+#ifndef _EXYNOS_MEM_LIB_INTERNALS_H_
+#define _EXYNOS_MEM_LIB_INTERNALS_H_
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#define SCTLR_M BIT0
+#define SCTLR_A BIT1
+#define SCTLR_C BIT2
+
+#define DCZID_DZP BIT4
+#define DCZID_BS_MASK 0xF
+
+// Below this the setup cost of the NEON loops is not worth paying
+#define EXYNOS_MEM_NEON_THRESHOLD 64
+
+//
+// AArch64/MemLibNeon.S
+//
+// The NEON and DC ZVA routines may only be used with the MMU and data cache
+// enabled: before that every data access is Device-nGnRnE, where unaligned
+// accesses and DC ZVA fault.
+//
+UINTN
+EFIAPI
+ExynosMemReadSctlr(VOID);
+
+UINTN
+EFIAPI
+ExynosMemReadDczid(VOID);
+
+VOID *
+EFIAPI
+ExynosMemCopyNeon(OUT VOID *Destination, IN CONST VOID *Source, IN UINTN Length);
+
+VOID *
+EFIAPI
+ExynosMemSetNeon(OUT VOID *Buffer, IN UINTN Length, IN UINT8 Value);
+
+VOID *
+EFIAPI
+ExynosMemZeroZva(OUT VOID *Buffer, IN UINTN Length, IN UINTN BlockSize);
+
+#endif /* _EXYNOS_MEM_LIB_INTERNALS_H_ */
@@ -0,0 +1,219 @@
+/** @file
+  FrameBufferBltLib for 32bpp BGRX framebuffers.
+
+  SimpleFbDxe always reports PixelBlueGreenRedReserved8BitPerColor, which is
+  bit-for-bit the EFI_GRAPHICS_OUTPUT_BLT_PIXEL layout, so every operation is
+  a plain 32-bit row fill or row copy with no pixel conversion and no scratch
+  line buffer.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/FrameBufferBltLib.h>
+
+#define FRAME_BUFFER_CONFIGURE_SIGNATURE SIGNATURE_32('E', 'B', 'L', 'T')
+
+struct FRAME_BUFFER_CONFIGURE {
+  UINT32  Signature;
+  UINT32 *FrameBuffer;
+  UINTN   Width;
+  UINTN   Height;
+  UINTN   PixelsPerScanLine;
+};
+
+// Row kernels, AArch64/BltRows.S
+VOID ExynosBltFillRow(UINT32 *Destination, UINTN Pixels, UINT32 Color);
+VOID ExynosBltCopyRow(
+    UINT32 *Destination, CONST UINT32 *Source, UINTN Pixels);
+VOID ExynosBltCopyRowBackward(
+    UINT32 *Destination, CONST UINT32 *Source, UINTN Pixels);
+
+/**
+  Create the configuration for a video frame buffer.
+
+  @param[in] FrameBuffer       Pointer to the start of the frame buffer.
+  @param[in] FrameBufferInfo   Describes the frame buffer characteristics.
+  @param[in,out] Configure     The created configuration information.
+  @param[in,out] ConfigureSize Size of the configuration information.
+
+  @retval RETURN_SUCCESS            The configuration was successful created.
+  @retval RETURN_BUFFER_TOO_SMALL   The Configure is to too small. The required
+                                    size is returned in ConfigureSize.
+  @retval RETURN_UNSUPPORTED        The requested mode is not supported by
+                                    this implementaion.
+**/
+RETURN_STATUS
+EFIAPI
+FrameBufferBltConfigure(
+    IN VOID                                 *FrameBuffer,
+    IN EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *FrameBufferInfo,
+    IN OUT FRAME_BUFFER_CONFIGURE           *Configure,
+    IN OUT UINTN                            *ConfigureSize)
+{
+  if (ConfigureSize == NULL || FrameBuffer == NULL || FrameBufferInfo == NULL)
+    return RETURN_INVALID_PARAMETER;
+
+  if (FrameBufferInfo->PixelFormat != PixelBlueGreenRedReserved8BitPerColor)
+    return RETURN_UNSUPPORTED;
+
+  if (FrameBufferInfo->PixelsPerScanLine < FrameBufferInfo->HorizontalResolution)
+    return RETURN_UNSUPPORTED;
+
+  if (Configure == NULL || *ConfigureSize < sizeof(FRAME_BUFFER_CONFIGURE)) {
+    *ConfigureSize = sizeof(FRAME_BUFFER_CONFIGURE);
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+
+  Configure->Signature         = FRAME_BUFFER_CONFIGURE_SIGNATURE;
+  Configure->FrameBuffer       = FrameBuffer;
+  Configure->Width             = FrameBufferInfo->HorizontalResolution;
+  Configure->Height            = FrameBufferInfo->VerticalResolution;
+  Configure->PixelsPerScanLine = FrameBufferInfo->PixelsPerScanLine;
+
+  return RETURN_SUCCESS;
+}
+
+STATIC
+BOOLEAN
+BltRectInScreen(
+    IN FRAME_BUFFER_CONFIGURE *Configure, IN UINTN X, IN UINTN Y,
+    IN UINTN Width, IN UINTN Height)
+{
+  return X < Configure->Width && Width <= Configure->Width - X &&
+         Y < Configure->Height && Height <= Configure->Height - Y;
+}
+
+STATIC
+UINT32 *
+BltScreenRow(IN FRAME_BUFFER_CONFIGURE *Configure, IN UINTN X, IN UINTN Y)
+{
+  return Configure->FrameBuffer + Y * Configure->PixelsPerScanLine + X;
+}
+
+STATIC
+UINT32 *
+BltBufferRow(
+    IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL *BltBuffer, IN UINTN Delta, IN UINTN X,
+    IN UINTN Y)
+{
+  return (UINT32 *)((UINT8 *)BltBuffer + Y * Delta) + X;
+}
+
+/**
+  Performs a UEFI Graphics Output Protocol Blt operation.
+
+  @param[in]     Configure    Pointer to a configuration which was successfully
+                              created by FrameBufferBltConfigure ().
+  @param[in,out] BltBuffer    The data to transfer to screen.
+  @param[in]     BltOperation The operation to perform.
+  @param[in]     SourceX      The X coordinate of the source for BltOperation.
+  @param[in]     SourceY      The Y coordinate of the source for BltOperation.
+  @param[in]     DestinationX The X coordinate of the destination for
+                              BltOperation.
+  @param[in]     DestinationY The Y coordinate of the destination for
+                              BltOperation.
+  @param[in]     Width        The width of a rectangle in the blt rectangle
+                              in pixels.
+  @param[in]     Height       The height of a rectangle in the blt rectangle
+                              in pixels.
+  @param[in]     Delta        Not used for EfiBltVideoFill and
+                              EfiBltVideoToVideo operation. If a Delta of 0
+                              is used, the entire BltBuffer will be operated
+                              on. If a subrectangle of the BltBuffer is used,
+                              then Delta represents the number of bytes in a
+                              row of the BltBuffer.
+
+  @retval RETURN_INVALID_PARAMETER Invalid parameter were passed in.
+  @retval RETURN_SUCCESS           The operation was performed successfully.
+**/
+RETURN_STATUS
+EFIAPI
+FrameBufferBlt(
+    IN FRAME_BUFFER_CONFIGURE                *Configure,
+    IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL     *BltBuffer OPTIONAL,
+    IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION      BltOperation,
+    IN UINTN SourceX, IN UINTN SourceY, IN UINTN DestinationX,
+    IN UINTN DestinationY, IN UINTN Width, IN UINTN Height, IN UINTN Delta)
+{
+  UINTN Row;
+
+  if (Configure == NULL ||
+      Configure->Signature != FRAME_BUFFER_CONFIGURE_SIGNATURE)
+    return RETURN_INVALID_PARAMETER;
+
+  if (Width == 0 || Height == 0)
+    return RETURN_INVALID_PARAMETER;
+
+  if (Delta == 0)
+    Delta = Width * sizeof(EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+
+  switch (BltOperation) {
+  case EfiBltVideoFill:
+    if (BltBuffer == NULL ||
+        !BltRectInScreen(Configure, DestinationX, DestinationY, Width, Height))
+      return RETURN_INVALID_PARAMETER;
+
+    for (Row = 0; Row < Height; Row++)
+      ExynosBltFillRow(
+          BltScreenRow(Configure, DestinationX, DestinationY + Row), Width,
+          *(UINT32 *)BltBuffer);
+    break;
+
+  case EfiBltVideoToBltBuffer:
+    if (BltBuffer == NULL ||
+        !BltRectInScreen(Configure, SourceX, SourceY, Width, Height))
+      return RETURN_INVALID_PARAMETER;
+
+    for (Row = 0; Row < Height; Row++)
+      ExynosBltCopyRow(
+          BltBufferRow(BltBuffer, Delta, DestinationX, DestinationY + Row),
+          BltScreenRow(Configure, SourceX, SourceY + Row), Width);
+    break;
+
+  case EfiBltBufferToVideo:
+    if (BltBuffer == NULL ||
+        !BltRectInScreen(Configure, DestinationX, DestinationY, Width, Height))
+      return RETURN_INVALID_PARAMETER;
+
+    for (Row = 0; Row < Height; Row++)
+      ExynosBltCopyRow(
+          BltScreenRow(Configure, DestinationX, DestinationY + Row),
+          BltBufferRow(BltBuffer, Delta, SourceX, SourceY + Row), Width);
+    break;
+
+  case EfiBltVideoToVideo:
+    if (!BltRectInScreen(Configure, SourceX, SourceY, Width, Height) ||
+        !BltRectInScreen(Configure, DestinationX, DestinationY, Width, Height))
+      return RETURN_INVALID_PARAMETER;
+
+    // Walk rows away from the overlap so no source row is overwritten
+    // before it has been read
+    if (DestinationY > SourceY) {
+      for (Row = Height; Row-- > 0;)
+        ExynosBltCopyRow(
+            BltScreenRow(Configure, DestinationX, DestinationY + Row),
+            BltScreenRow(Configure, SourceX, SourceY + Row), Width);
+    }
+    else if (DestinationY == SourceY && DestinationX > SourceX) {
+      for (Row = 0; Row < Height; Row++)
+        ExynosBltCopyRowBackward(
+            BltScreenRow(Configure, DestinationX, DestinationY + Row),
+            BltScreenRow(Configure, SourceX, SourceY + Row), Width);
+    }
+    else if (DestinationY != SourceY || DestinationX != SourceX) {
+      for (Row = 0; Row < Height; Row++)
+        ExynosBltCopyRow(
+            BltScreenRow(Configure, DestinationX, DestinationY + Row),
+            BltScreenRow(Configure, SourceX, SourceY + Row), Width);
+    }
+    break;
+
+  default:
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -11,26 +11,79 @@
 
 #include "Library/FrameBufferSerialPortLib.h"
 
-FBCON_POSITION m_Position;
 FBCON_POSITION m_MaxPosition;
 FBCON_COLOR    m_Color;
 BOOLEAN        m_Initialized = FALSE;
+// Render every write immediately instead of at newlines
+BOOLEAN        m_Synchronous = FALSE;
 
 UINTN gWidth = FixedPcdGet32(PcdMipiFrameBufferWidth);
 // Reserve half screen for output
 UINTN gHeight = FixedPcdGet32(PcdMipiFrameBufferHeight);
 UINTN gBpp    = FixedPcdGet32(PcdMipiFrameBufferPixelBpp);
 
+// FbConInitGrid makes the largest grid at scale factor 1
+STATIC_ASSERT(
+    FBCON_SHARED_STATE_SIZE(
+        FixedPcdGet32(PcdMipiFrameBufferWidth) / (FONT_WIDTH + 1),
+        (FixedPcdGet32(PcdMipiFrameBufferHeight) - 1) / FONT_HEIGHT) <=
+        FixedPcdGet32(PcdFbConStateSize),
+    "PcdFbConStateSize is too small for the FbCon cell grids");
+
+// Glyph atlas: every distinct FONT_WIDTH-bit font row, pre-expanded to the
+// current colours, bpp and scale factor, so a glyph is drawn as
+// FONT_HEIGHT * scale_factor row copies instead of pixel by pixel.
+#define FBCON_ATLAS_MAX_SCALE_FACTOR 4
+#define FBCON_ATLAS_MAX_BYTES_PER_PIXEL 4
+#define FBCON_ATLAS_ROW_PATTERNS (1 << FONT_WIDTH)
+
+typedef struct _FBCON_GLYPH_ATLAS {
+  BOOLEAN  Valid;
+  UINTN    Foreground;
+  UINTN    Background;
+  unsigned Bpp;
+  unsigned ScaleFactor;
+  unsigned RowBytes;
+  UINT8    Rows[FBCON_ATLAS_ROW_PATTERNS]
+            [FONT_WIDTH * FBCON_ATLAS_MAX_SCALE_FACTOR *
+             FBCON_ATLAS_MAX_BYTES_PER_PIXEL];
+} FBCON_GLYPH_ATLAS;
+
+FBCON_GLYPH_ATLAS m_GlyphAtlas;
+
+// Cell attributes index this table; the background is always
+// m_Color.Background.
+STATIC CONST UINTN m_Palette[] = {
+    FB_BGRA8888_WHITE, FB_BGRA8888_YELLOW, FB_BGRA8888_CYAN,
+    FB_BGRA8888_BLUE,  FB_BGRA8888_SILVER, FB_BGRA8888_ORANGE,
+    FB_BGRA8888_RED,   FB_BGRA8888_GREEN,
+};
+
+// Framebuffer pixel rows written since the last flush
+UINTN m_DirtyStart = MAX_UINTN;
+UINTN m_DirtyEnd   = 0;
+
 // Module-used internal routine
 void FbConPutCharWithFactor(char c, int type, unsigned scale_factor);
 
 void FbConDrawglyph(
     char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
     unsigned scale_factor);
+void FbConDrawglyphPixels(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor);
+void FbConBuildGlyphAtlas(unsigned bpp, unsigned scale_factor);
 
 void FbConReset(void);
-void FbConScrollUp(void);
+void FbConInitGrid(unsigned scale_factor);
+void FbConDrawCell(UINTN col, UINTN row, FBCON_CELL cell, unsigned scale_factor);
+void FbConClearRow(UINTN row, unsigned scale_factor);
+void FbConRepaint(unsigned scale_factor);
+void FbConScrollUp(unsigned scale_factor);
+void FbConMarkDirty(UINTN row, UINTN rows);
 void FbConFlush(void);
+void  FbConQueue(UINT8 *Buffer, UINTN NumberOfBytes);
+UINTN FbConDrain(void);
 
 RETURN_STATUS
 EFIAPI
@@ -49,6 +102,9 @@ SerialPortInitialize(VOID)
   // Reset console
   FbConReset();
 
+  // Pre-render the glyph atlas for the default colours
+  FbConBuildGlyphAtlas((gBpp / 8), SCALE_FACTOR);
+
   // Set flag
   m_Initialized = TRUE;
 
@@ -64,6 +120,11 @@ void ResetFb(void)
   UINTN BgColor = FB_BGRA8888_BLACK;
 
   // Set to black color.
+  if (gBpp == 32) {
+    SetMem32(Pixels, gWidth * gHeight * sizeof(UINT32), BgColor);
+    return;
+  }
+
   for (UINTN i = 0; i < gWidth; i++) {
     for (UINTN j = 0; j < gHeight; j++) {
       BgColor = FB_BGRA8888_BLACK;
@@ -79,10 +140,6 @@ void ResetFb(void)
 
 void FbConReset(void)
 {
-  // Reset position.
-  m_Position.x = 0;
-  m_Position.y = 0;
-
   // Calc max position.
   m_MaxPosition.x = gWidth / (FONT_WIDTH + 1);
   m_MaxPosition.y = (gHeight - 1) / FONT_HEIGHT;
@@ -92,15 +149,35 @@ void FbConReset(void)
   m_Color.Background = FB_BGRA8888_BLACK;
 }
 
+void FbConInitGrid(unsigned scale_factor)
+{
+  PFBCON_SHARED_STATE State   = FBCON_SHARED_STATE_ADDRESS;
+  UINT32              Columns = m_MaxPosition.x / scale_factor;
+  // Keep one row of margin at the bottom of the panel
+  UINT32              Rows    = m_MaxPosition.y / scale_factor - 1;
+
+  // The grid outlives modules; only the first writer of a boot sets it up
+  if (State->Columns == Columns && State->Rows == Rows)
+    return;
+
+  ZeroMem(FBCON_SHARED_CELLS(State), 2 * Columns * Rows * sizeof(FBCON_CELL));
+  State->Columns   = Columns;
+  State->Rows      = Rows;
+  State->PositionX = 0;
+  State->PositionY = 0;
+}
+
 void FbConPutCharWithFactor(char c, int type, unsigned scale_factor)
 {
-  char *Pixels;
+  PFBCON_SHARED_STATE State = FBCON_SHARED_STATE_ADDRESS;
+  PFBCON_CELL         Text;
+  PFBCON_CELL         Screen;
+  FBCON_CELL          Cell;
+  UINTN               Index;
 
   if (!m_Initialized)
     return;
 
-paint:
-
   if ((unsigned char)c > 127)
     return;
 
@@ -109,7 +186,7 @@ paint:
       goto newline;
     }
     else if (c == '\r') {
-      m_Position.x = 0;
+      State->PositionX = 0;
       return;
     }
     else {
@@ -118,193 +195,324 @@ paint:
   }
 
   // Save some space
-  if (m_Position.x == 0 && (unsigned char)c == ' ' &&
+  if (State->PositionX == 0 && (unsigned char)c == ' ' &&
       type != FBCON_SUBTITLE_MSG && type != FBCON_TITLE_MSG)
     return;
 
-  BOOLEAN intstate = ArmGetInterruptState();
-  ArmDisableInterrupts();
+  FbConInitGrid(scale_factor);
 
-  Pixels = (void *)FixedPcdGet32(PcdMipiFrameBufferAddress);
-  Pixels += m_Position.y * ((gBpp / 8) * FONT_HEIGHT * gWidth);
-  Pixels += m_Position.x * scale_factor * ((gBpp / 8) * (FONT_WIDTH + 1));
+  Cell.Char      = c;
+  Cell.Attribute = 0;
+  for (Index = 0; Index < ARRAY_SIZE(m_Palette); Index++) {
+    if (m_Palette[Index] == m_Color.Foreground) {
+      Cell.Attribute = Index;
+      break;
+    }
+  }
 
-  FbConDrawglyph(
-      Pixels, gWidth, (gBpp / 8), font5x12 + (c - 32) * 2, scale_factor);
+  Text   = FBCON_SHARED_CELLS(State);
+  Screen = Text + State->Columns * State->Rows;
+  Index  = State->PositionY * State->Columns + State->PositionX;
 
-  m_Position.x++;
+  FbConDrawCell(State->PositionX, State->PositionY, Cell, scale_factor);
+  Text[Index]   = Cell;
+  Screen[Index] = Cell;
 
-  if (m_Position.x >= (int)(m_MaxPosition.x / scale_factor))
-    goto newline;
+  State->PositionX++;
 
-  if (intstate)
-    ArmEnableInterrupts();
-  return;
+  if (State->PositionX < (INTN)State->Columns)
+    return;
 
 newline:
-  m_Position.y += scale_factor;
-  m_Position.x = 0;
-  if (m_Position.y >= m_MaxPosition.y - scale_factor) {
-    FbConFlush();
-    m_Position.y = 0;
+  FbConInitGrid(scale_factor);
+
+  State->PositionX = 0;
+  State->PositionY++;
+  State->LinesRendered++;
+  if (State->PositionY >= (INTN)State->Rows)
+    FbConScrollUp(scale_factor);
+  else
+    FbConClearRow(State->PositionY, scale_factor);
+}
 
-    if (intstate)
-      ArmEnableInterrupts();
-    goto paint;
-  }
-  else {
-    Pixels = (void *)FixedPcdGet32(PcdMipiFrameBufferAddress);
-    Pixels += m_Position.y * ((gBpp / 8) * FONT_HEIGHT * gWidth);
-    ZeroMem(Pixels, ((gBpp / 8) * FONT_HEIGHT * gWidth) * scale_factor);
-    FbConFlush();
-    if (intstate)
-      ArmEnableInterrupts();
-  }
+void FbConDrawCell(UINTN col, UINTN row, FBCON_CELL cell, unsigned scale_factor)
+{
+  char *Pixels            = (void *)FixedPcdGet32(PcdMipiFrameBufferAddress);
+  UINTN CurrentForeground = m_Color.Foreground;
+
+  // Empty cells are drawn as spaces
+  if ((unsigned char)cell.Char < 32 || (unsigned char)cell.Char > 127)
+    cell.Char = ' ';
+  if (cell.Attribute < ARRAY_SIZE(m_Palette))
+    m_Color.Foreground = m_Palette[cell.Attribute];
+
+  Pixels += row * scale_factor * ((gBpp / 8) * FONT_HEIGHT * gWidth);
+  Pixels += col * scale_factor * ((gBpp / 8) * (FONT_WIDTH + 1));
+
+  FbConDrawglyph(
+      Pixels, gWidth, (gBpp / 8), font5x12 + (cell.Char - 32) * 2,
+      scale_factor);
+  FbConMarkDirty(row * scale_factor * FONT_HEIGHT, FONT_HEIGHT * scale_factor);
+  FBCON_SHARED_STATE_ADDRESS->CellsDrawn++;
+
+  m_Color.Foreground = CurrentForeground;
 }
 
-void FbConDrawglyph(
-    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
-    unsigned scale_factor)
+void FbConClearRow(UINTN row, unsigned scale_factor)
 {
-  char *       bg_pixels = pixels;
-  unsigned     x, y, i, j, k;
-  unsigned     data, temp;
-  unsigned int fg_color = m_Color.Foreground;
-  unsigned int bg_color = m_Color.Background;
-  stride -= FONT_WIDTH * scale_factor;
+  PFBCON_SHARED_STATE State    = FBCON_SHARED_STATE_ADDRESS;
+  PFBCON_CELL         Text     = FBCON_SHARED_CELLS(State);
+  PFBCON_CELL         Screen   = Text + State->Columns * State->Rows;
+  UINTN               RowBytes = (gBpp / 8) * FONT_HEIGHT * gWidth;
+  char               *Pixels   = (void *)FixedPcdGet32(PcdMipiFrameBufferAddress);
+
+  ZeroMem(Text + row * State->Columns, State->Columns * sizeof(FBCON_CELL));
+  ZeroMem(Screen + row * State->Columns, State->Columns * sizeof(FBCON_CELL));
+
+  Pixels += row * scale_factor * RowBytes;
+  ZeroMem(Pixels, RowBytes * scale_factor);
+  FbConMarkDirty(row * scale_factor * FONT_HEIGHT, FONT_HEIGHT * scale_factor);
+}
 
-  for (y = 0; y < FONT_HEIGHT / 2; ++y) {
-    for (i = 0; i < scale_factor; i++) {
-      for (x = 0; x < FONT_WIDTH; ++x) {
-        for (j = 0; j < scale_factor; j++) {
-          bg_color = m_Color.Background;
-          for (k = 0; k < bpp; k++) {
-            *bg_pixels = (unsigned char)bg_color;
-            bg_color   = bg_color >> 8;
-            bg_pixels++;
-          }
-        }
-      }
-      bg_pixels += (stride * bpp);
+// Redraw every cell whose text differs from what is on screen
+void FbConRepaint(unsigned scale_factor)
+{
+  PFBCON_SHARED_STATE State  = FBCON_SHARED_STATE_ADDRESS;
+  PFBCON_CELL         Text   = FBCON_SHARED_CELLS(State);
+  PFBCON_CELL         Screen = Text + State->Columns * State->Rows;
+  UINTN               Row, Col, Index;
+
+  for (Row = 0; Row < State->Rows; Row++) {
+    for (Col = 0; Col < State->Columns; Col++) {
+      Index = Row * State->Columns + Col;
+      if (Text[Index].Char == Screen[Index].Char &&
+          Text[Index].Attribute == Screen[Index].Attribute)
+        continue;
+
+      FbConDrawCell(Col, Row, Text[Index], scale_factor);
+      Screen[Index] = Text[Index];
     }
   }
+}
 
-  for (y = 0; y < FONT_HEIGHT / 2; ++y) {
-    for (i = 0; i < scale_factor; i++) {
-      for (x = 0; x < FONT_WIDTH; ++x) {
-        for (j = 0; j < scale_factor; j++) {
-          bg_color = m_Color.Background;
-          for (k = 0; k < bpp; k++) {
-            *bg_pixels = (unsigned char)bg_color;
-            bg_color   = bg_color >> 8;
-            bg_pixels++;
-          }
+void FbConBuildGlyphAtlas(unsigned bpp, unsigned scale_factor)
+{
+  UINT8   *row;
+  unsigned pattern, x, j, k;
+  UINTN    color;
+
+  for (pattern = 0; pattern < FBCON_ATLAS_ROW_PATTERNS; pattern++) {
+    row = m_GlyphAtlas.Rows[pattern];
+    for (x = 0; x < FONT_WIDTH; ++x) {
+      for (j = 0; j < scale_factor; j++) {
+        color = (pattern & (1 << x)) ? m_Color.Foreground : m_Color.Background;
+        for (k = 0; k < bpp; k++) {
+          *row++ = (UINT8)color;
+          color  = color >> 8;
         }
       }
-      bg_pixels += (stride * bpp);
     }
   }
 
-  data = glyph[0];
-  for (y = 0; y < FONT_HEIGHT / 2; ++y) {
-    temp = data;
+  m_GlyphAtlas.Foreground  = m_Color.Foreground;
+  m_GlyphAtlas.Background  = m_Color.Background;
+  m_GlyphAtlas.Bpp         = bpp;
+  m_GlyphAtlas.ScaleFactor = scale_factor;
+  m_GlyphAtlas.RowBytes    = FONT_WIDTH * scale_factor * bpp;
+  m_GlyphAtlas.Valid       = TRUE;
+}
+
+void FbConDrawglyph(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor)
+{
+  unsigned y, i;
+  unsigned data;
+
+  // Layouts the atlas has no room for are drawn pixel by pixel
+  if (scale_factor > FBCON_ATLAS_MAX_SCALE_FACTOR ||
+      bpp > FBCON_ATLAS_MAX_BYTES_PER_PIXEL) {
+    FbConDrawglyphPixels(pixels, stride, bpp, glyph, scale_factor);
+    return;
+  }
+
+  // Only rebuild when colours (e.g. SerialPortWriteCritical) or layout change
+  if (!m_GlyphAtlas.Valid || m_GlyphAtlas.Foreground != m_Color.Foreground ||
+      m_GlyphAtlas.Background != m_Color.Background ||
+      m_GlyphAtlas.Bpp != bpp || m_GlyphAtlas.ScaleFactor != scale_factor)
+    FbConBuildGlyphAtlas(bpp, scale_factor);
+
+  // Each glyph word holds FONT_HEIGHT / 2 rows of FONT_WIDTH bits
+  for (y = 0; y < FONT_HEIGHT; ++y) {
+    data = glyph[y / (FONT_HEIGHT / 2)] >> ((y % (FONT_HEIGHT / 2)) * FONT_WIDTH);
+    data &= FBCON_ATLAS_ROW_PATTERNS - 1;
+
     for (i = 0; i < scale_factor; i++) {
-      data = temp;
-      for (x = 0; x < FONT_WIDTH; ++x) {
-        if (data & 1) {
-          for (j = 0; j < scale_factor; j++) {
-            fg_color = m_Color.Foreground;
-            for (k = 0; k < bpp; k++) {
-              *pixels  = (unsigned char)fg_color;
-              fg_color = fg_color >> 8;
-              pixels++;
-            }
-          }
-        }
-        else {
-          for (j = 0; j < scale_factor; j++) {
-            pixels = pixels + bpp;
-          }
-        }
-        data >>= 1;
-      }
-      pixels += (stride * bpp);
+      CopyMem(pixels, m_GlyphAtlas.Rows[data], m_GlyphAtlas.RowBytes);
+      pixels += stride * bpp;
     }
   }
+}
+
+void FbConDrawglyphPixels(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor)
+{
+  unsigned x, y, i, j, k;
+  unsigned data;
+  UINTN    color;
+
+  stride -= FONT_WIDTH * scale_factor;
+
+  for (y = 0; y < FONT_HEIGHT; ++y) {
+    data = glyph[y / (FONT_HEIGHT / 2)] >> ((y % (FONT_HEIGHT / 2)) * FONT_WIDTH);
 
-  data = glyph[1];
-  for (y = 0; y < FONT_HEIGHT / 2; ++y) {
-    temp = data;
     for (i = 0; i < scale_factor; i++) {
-      data = temp;
       for (x = 0; x < FONT_WIDTH; ++x) {
-        if (data & 1) {
-          for (j = 0; j < scale_factor; j++) {
-            fg_color = m_Color.Foreground;
-            for (k = 0; k < bpp; k++) {
-              *pixels  = (unsigned char)fg_color;
-              fg_color = fg_color >> 8;
-              pixels++;
-            }
-          }
-        }
-        else {
-          for (j = 0; j < scale_factor; j++) {
-            pixels = pixels + bpp;
+        for (j = 0; j < scale_factor; j++) {
+          color = (data & (1 << x)) ? m_Color.Foreground : m_Color.Background;
+          for (k = 0; k < bpp; k++) {
+            *pixels++ = (unsigned char)color;
+            color     = color >> 8;
           }
         }
-        data >>= 1;
       }
-      pixels += (stride * bpp);
+      pixels += stride * bpp;
     }
   }
 }
 
-/* TODO: Take stride into account */
-void FbConScrollUp(void)
+// Scroll by half a screen at a time: the text moves up in one bulk copy and
+// the repaint touches each changed cell once, so the cost per output line
+// does not grow with the number of rows on the panel.
+void FbConScrollUp(unsigned scale_factor)
 {
-  unsigned short *dst   = (void *)FixedPcdGet32(PcdMipiFrameBufferAddress);
-  unsigned short *src   = dst + (gWidth * FONT_HEIGHT);
-  unsigned        count = gWidth * (gHeight - FONT_HEIGHT);
+  PFBCON_SHARED_STATE State = FBCON_SHARED_STATE_ADDRESS;
+  PFBCON_CELL         Text  = FBCON_SHARED_CELLS(State);
+  UINTN               Shift = State->Rows / 2;
+  UINTN               Keep;
 
-  while (count--) {
-    *dst++ = *src++;
-  }
+  if (Shift == 0)
+    Shift = 1;
+  Keep = State->Rows - Shift;
 
-  count = gWidth * FONT_HEIGHT;
-  while (count--) {
-    *dst++ = m_Color.Background;
-  }
+  CopyMem(
+      Text, Text + Shift * State->Columns,
+      Keep * State->Columns * sizeof(FBCON_CELL));
+  ZeroMem(
+      Text + Keep * State->Columns,
+      Shift * State->Columns * sizeof(FBCON_CELL));
 
-  FbConFlush();
+  State->PositionY = Keep;
+
+  FbConRepaint(scale_factor);
+}
+
+void FbConMarkDirty(UINTN row, UINTN rows)
+{
+  if (row < m_DirtyStart)
+    m_DirtyStart = row;
+  if (row + rows > m_DirtyEnd)
+    m_DirtyEnd = row + rows;
 }
 
 void FbConFlush(void)
 {
-  unsigned total_x, total_y;
-  unsigned bytes_per_bpp;
+  UINTN line_bytes = gWidth * (gBpp / 8);
+  UINTN length;
 
-  total_x       = gWidth;
-  total_y       = gHeight;
-  bytes_per_bpp = (gBpp / 8);
+  // Only clean the band of rows touched since the last flush
+  if (m_DirtyEnd > gHeight)
+    m_DirtyEnd = gHeight;
+  if (m_DirtyStart >= m_DirtyEnd)
+    return;
 
+  length = (m_DirtyEnd - m_DirtyStart) * line_bytes;
   WriteBackInvalidateDataCacheRange(
-      (void *)FixedPcdGet32(PcdMipiFrameBufferAddress),
-      (total_x * total_y * bytes_per_bpp));
+      (void *)(FixedPcdGet32(PcdMipiFrameBufferAddress) +
+               m_DirtyStart * line_bytes),
+      length);
+
+  FBCON_SHARED_STATE_ADDRESS->CacheBytesCleaned += length;
+
+  m_DirtyStart = MAX_UINTN;
+  m_DirtyEnd   = 0;
+}
+
+void FbConQueue(UINT8 *Buffer, UINTN NumberOfBytes)
+{
+  PFBCON_SHARED_STATE State = FBCON_SHARED_STATE_ADDRESS;
+  UINTN               Offset;
+  UINTN               Chunk;
+
+  while (NumberOfBytes > 0) {
+    // Ring full: render what is queued to make room
+    if ((UINT32)(State->RingHead - State->RingTail) >= FBCON_RING_SIZE)
+      FbConDrain();
+
+    Offset = State->RingHead % FBCON_RING_SIZE;
+    Chunk  = MIN(NumberOfBytes, FBCON_RING_SIZE - Offset);
+    Chunk  = MIN(
+        Chunk, FBCON_RING_SIZE - (UINT32)(State->RingHead - State->RingTail));
+
+    CopyMem(&State->Ring[Offset], Buffer, Chunk);
+    State->RingHead += Chunk;
+    Buffer += Chunk;
+    NumberOfBytes -= Chunk;
+  }
+}
+
+// Callers hold interrupts off
+UINTN FbConDrain(void)
+{
+  PFBCON_SHARED_STATE State = FBCON_SHARED_STATE_ADDRESS;
+  UINTN               Count = 0;
+
+  // Platforms that never clear the shared state leave junk indices behind
+  if ((UINT32)(State->RingHead - State->RingTail) > FBCON_RING_SIZE)
+    State->RingTail = State->RingHead;
+
+  while (State->RingTail != State->RingHead) {
+    FbConPutCharWithFactor(
+        State->Ring[State->RingTail % FBCON_RING_SIZE], FBCON_COMMON_MSG,
+        SCALE_FACTOR);
+    State->RingTail++;
+    Count++;
+  }
+
+  FbConFlush();
+  return Count;
 }
 
 UINTN
 EFIAPI
 SerialPortWrite(IN UINT8 *Buffer, IN UINTN NumberOfBytes)
 {
-  UINT8 *CONST Final          = &Buffer[NumberOfBytes];
-  UINTN        InterruptState = ArmGetInterruptState();
+  UINTN InterruptState;
+
+  if (!m_Initialized || NumberOfBytes == 0)
+    return NumberOfBytes;
+
+  InterruptState = ArmGetInterruptState();
   ArmDisableInterrupts();
 
-  while (Buffer < Final) {
-    FbConPutCharWithFactor(*Buffer++, FBCON_COMMON_MSG, SCALE_FACTOR);
+  PersistentLogAppend(Buffer, NumberOfBytes);
+
+  if (FeaturePcdGet(PcdFbConHeadless)) {
+    if (InterruptState)
+      ArmEnableInterrupts();
+    return NumberOfBytes;
   }
 
+  FbConQueue(Buffer, NumberOfBytes);
+
+  // Render whole lines as one batch. Partial lines wait for the next
+  // newline, a full ring or SerialPortFlush (SimpleFbDxe calls it from a
+  // timer). ASSERT messages end in a newline, so they are always drawn
+  // before the dead loop.
+  if (m_Synchronous || ScanMem8(Buffer, NumberOfBytes, '\n') != NULL)
+    FbConDrain();
+
   if (InterruptState)
     ArmEnableInterrupts();
   return NumberOfBytes;
@@ -319,6 +527,18 @@ SerialPortWriteCritical(IN UINT8 *Buffer, IN UINTN NumberOfBytes)
   UINTN        InterruptState    = ArmGetInterruptState();
 
   ArmDisableInterrupts();
+
+  PersistentLogAppend(Buffer, NumberOfBytes);
+
+  if (FeaturePcdGet(PcdFbConHeadless)) {
+    if (InterruptState)
+      ArmEnableInterrupts();
+    return NumberOfBytes;
+  }
+
+  // Keep ordering with output queued before this message
+  FbConDrain();
+
   m_Color.Foreground = FB_BGRA8888_YELLOW;
 
   while (Buffer < Final) {
@@ -327,6 +547,8 @@ SerialPortWriteCritical(IN UINT8 *Buffer, IN UINTN NumberOfBytes)
 
   m_Color.Foreground = CurrentForeground;
 
+  FbConFlush();
+
   if (InterruptState)
     ArmEnableInterrupts();
   return NumberOfBytes;
@@ -358,9 +580,26 @@ SerialPortSetAttributes(
   return RETURN_UNSUPPORTED;
 }
 
-UINTN SerialPortFlush(VOID) { return 0; }
+UINTN SerialPortFlush(VOID)
+{
+  UINTN Count;
+  UINTN InterruptState;
+
+  if (!m_Initialized)
+    return 0;
+
+  InterruptState = ArmGetInterruptState();
+  ArmDisableInterrupts();
+
+  Count = FbConDrain();
+
+  if (InterruptState)
+    ArmEnableInterrupts();
+  return Count;
+}
 
 VOID EnableSynchronousSerialPortIO(VOID)
 {
-  // Already synchronous
+  m_Synchronous = TRUE;
+  SerialPortFlush();
 }
@@ -0,0 +1,109 @@
+#include <PiDxe.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+
+#include <Configuration/PersistentLog.h>
+
+#include "Library/FrameBufferSerialPortLib.h"
+
+#define PERSISTENT_LOG_ADDRESS                                                 \
+  ((PPERSISTENT_LOG_HEADER)(UINTN)FixedPcdGet64(PcdPersistentLogBase))
+
+STATIC
+UINT32
+PersistentLogCrc(PPERSISTENT_LOG_HEADER Log)
+{
+  PERSISTENT_LOG_HEADER Header;
+
+  CopyMem(&Header, Log, sizeof(Header));
+  Header.HeaderCrc = 0;
+  return CalculateCrc32(&Header, sizeof(Header));
+}
+
+STATIC
+BOOLEAN
+PersistentLogValid(PPERSISTENT_LOG_HEADER Log)
+{
+  return Log->Signature == PERSISTENT_LOG_SIGNATURE &&
+         Log->Size == FixedPcdGet32(PcdPersistentLogSize) -
+                          sizeof(PERSISTENT_LOG_HEADER) &&
+         Log->Head - Log->Tail <= Log->Size &&
+         Log->HeaderCrc == PersistentLogCrc(Log);
+}
+
+STATIC
+VOID
+PersistentLogReset(PPERSISTENT_LOG_HEADER Log)
+{
+  ZeroMem(Log, sizeof(*Log));
+  Log->Signature = PERSISTENT_LOG_SIGNATURE;
+  Log->Size      = FixedPcdGet32(PcdPersistentLogSize) - sizeof(*Log);
+  Log->HeaderCrc = PersistentLogCrc(Log);
+}
+
+BOOLEAN
+PersistentLogEnabled(VOID)
+{
+  return FixedPcdGet64(PcdPersistentLogBase) != 0 &&
+         FixedPcdGet32(PcdPersistentLogSize) > sizeof(PERSISTENT_LOG_HEADER);
+}
+
+VOID PersistentLogAppend(IN CONST UINT8 *Buffer, IN UINTN NumberOfBytes)
+{
+  PPERSISTENT_LOG_HEADER Log = PERSISTENT_LOG_ADDRESS;
+  UINTN                  Offset;
+  UINTN                  Chunk;
+
+  if (!PersistentLogEnabled() || NumberOfBytes == 0)
+    return;
+
+  // Started by a module before PrePi ran, or torn by a reset mid-write
+  if (!PersistentLogValid(Log))
+    PersistentLogReset(Log);
+
+  // Only the tail of an oversized write fits
+  if (NumberOfBytes > Log->Size) {
+    Buffer += NumberOfBytes - Log->Size;
+    NumberOfBytes = Log->Size;
+  }
+
+  while (NumberOfBytes > 0) {
+    Offset = Log->Head % Log->Size;
+    Chunk  = MIN(NumberOfBytes, Log->Size - Offset);
+
+    CopyMem(PERSISTENT_LOG_DATA(Log) + Offset, Buffer, Chunk);
+    Log->Head += Chunk;
+    Buffer += Chunk;
+    NumberOfBytes -= Chunk;
+  }
+
+  if (Log->Head - Log->Tail > Log->Size)
+    Log->Tail = Log->Head - Log->Size;
+
+  Log->HeaderCrc = PersistentLogCrc(Log);
+}
+
+VOID PersistentLogInitialize(VOID)
+{
+  PPERSISTENT_LOG_HEADER Log = PERSISTENT_LOG_ADDRESS;
+  CHAR8                  Marker[32];
+  UINTN                  Length;
+
+  if (!PersistentLogEnabled())
+    return;
+
+  // Keep what earlier boots logged if it survived the reset
+  if (!PersistentLogValid(Log))
+    PersistentLogReset(Log);
+
+  Log->BootCount++;
+  Log->BootStart = Log->Head;
+  Log->HeaderCrc = PersistentLogCrc(Log);
+
+  Length = AsciiSPrint(
+      Marker, sizeof(Marker), "\n--- boot %u ---\n", Log->BootCount);
+  PersistentLogAppend((CONST UINT8 *)Marker, Length);
+}
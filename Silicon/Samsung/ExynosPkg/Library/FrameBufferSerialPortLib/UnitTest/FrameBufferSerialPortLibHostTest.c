@@ -0,0 +1,373 @@
+/** @file
+  Host tests for FrameBufferSerialPortLib.
+
+  The library draws into a framebuffer mapped where PcdMipiFrameBufferAddress
+  points (HostFrameBufferLib), at the panel size ExynosPkg.dec defaults to.
+  What it draws is compared with the golden images in
+  FrameBufferSerialPortLibHostTestGolden.h; when a change to the renderer is
+  intended, the failing case prints the new image to paste in. The
+  throughput case reports characters per second and the framebuffer cache
+  maintenance done per line, the glyph case how much faster the glyph atlas
+  draws than the pixel by pixel fallback.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/ArmLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/FrameBufferSerialPortLib.h>
+#include <Library/HostCacheMaintenanceLib.h>
+#include <Library/HostFrameBufferLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "FrameBufferSerialPortLibHostTestGolden.h"
+
+#define UNIT_TEST_APP_NAME    "FrameBufferSerialPortLib Host Tests"
+#define UNIT_TEST_APP_VERSION "1.0"
+
+// font5x12.h also defines the font itself, so only the library includes it:
+// FONT_WIDTH by FONT_HEIGHT glyphs, drawn SCALE_FACTOR (2) times over into
+// text cells one pixel wider
+#define GLYPH_WIDTH  5
+#define GLYPH_HEIGHT 12
+#define CELL_WIDTH   ((GLYPH_WIDTH + 1) * 2)
+#define CELL_HEIGHT  (GLYPH_HEIGHT * 2)
+
+// Printable ASCII, the glyphs font5x12 holds
+#define GLYPH_COUNT (127 - 32)
+
+#define FRAME_BUFFER_SIZE                                                      \
+  (FixedPcdGet32(PcdMipiFrameBufferWidth) *                                   \
+   FixedPcdGet32(PcdMipiFrameBufferHeight) * sizeof(UINT32))
+
+// Lines written by the throughput case; enough to scroll the panel many times
+#define THROUGHPUT_LINES 4000
+
+// Times the glyph case draws the whole font at each scale factor
+#define GLYPH_ROUNDS 2000
+
+// FrameBufferSerialPortLib internals the glyph case calls directly
+typedef void (*GLYPH_DRAW)(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor);
+
+extern unsigned font5x12[];
+
+void FbConDrawglyph(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor);
+void FbConDrawglyphPixels(
+    char *pixels, unsigned stride, unsigned bpp, unsigned *glyph,
+    unsigned scale_factor);
+
+/**
+  Each case starts from a cleared panel and shared state, as after
+  InitializeSharedUartBuffers in PrePi.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ClearConsole(IN UNIT_TEST_CONTEXT Context)
+{
+  UT_ASSERT_NOT_NULL(HostFrameBufferMap());
+  HostCacheMaintenanceReset();
+  SerialPortInitialize();
+
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+VOID
+WriteString(IN CONST CHAR8 *String)
+{
+  SerialPortWrite((UINT8 *)String, AsciiStrLen(String));
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+LinesRenderAtNewline(IN UNIT_TEST_CONTEXT Context)
+{
+  WriteString("Hello\n");
+
+  //
+  // A write without a newline waits for the next one or a flush
+  //
+  WriteString("Wor");
+  UT_ASSERT_TRUE(HostFrameBufferMatches(
+      "HelloPending", 0, 0, 6 * CELL_WIDTH, 2 * CELL_HEIGHT, mHelloPending));
+
+  UT_ASSERT_EQUAL(SerialPortFlush(), 3);
+  UT_ASSERT_TRUE(HostFrameBufferMatches(
+      "HelloFlushed", 0, 0, 6 * CELL_WIDTH, 2 * CELL_HEIGHT, mHelloFlushed));
+
+  UT_ASSERT_EQUAL(FBCON_SHARED_STATE_ADDRESS->CellsDrawn, 8);
+  UT_ASSERT_EQUAL(FBCON_SHARED_STATE_ADDRESS->LinesRendered, 1);
+  UT_ASSERT_TRUE(ArmGetInterruptState());
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+CriticalOutputIsYellow(IN UNIT_TEST_CONTEXT Context)
+{
+  STATIC CHAR8 Critical[] = "FAIL\n";
+
+  //
+  // Queued output is drawn first, in the normal colour
+  //
+  WriteString("ok ");
+  SerialPortWriteCritical((UINT8 *)Critical, AsciiStrLen(Critical));
+
+  UT_ASSERT_TRUE(HostFrameBufferMatches(
+      "Critical", 0, 0, 8 * CELL_WIDTH, 2 * CELL_HEIGHT, mCritical));
+  UT_ASSERT_TRUE(ArmGetInterruptState());
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+LongLinesWrapAndScroll(IN UNIT_TEST_CONTEXT Context)
+{
+  PFBCON_SHARED_STATE State = FBCON_SHARED_STATE_ADDRESS;
+  CHAR8               Line[140];
+  UINTN               Index;
+  UINTN               Length;
+
+  //
+  // 100 lines of 1.5 panel widths each fill 200 rows: two scrolls on a
+  // panel of 88
+  //
+  for (Index = 0; Index < 100; Index++) {
+    Length = AsciiSPrint(Line, sizeof(Line), "%03u ", (UINT32)Index);
+    SetMem(&Line[Length], 135 - Length, 'x');
+    Line[135] = '\n';
+    Line[136] = '\0';
+    WriteString(Line);
+  }
+
+  UT_ASSERT_EQUAL(State->Columns, 90);
+  UT_ASSERT_EQUAL(State->Rows, 88);
+  UT_ASSERT_EQUAL(State->LinesRendered, 200);
+  UT_ASSERT_TRUE(HostFrameBufferMatches(
+      "ScrolledTop", 0, 0, 4 * CELL_WIDTH, 2 * CELL_HEIGHT, mScrolledTop));
+  UT_ASSERT_EQUAL(HostFrameBufferCrc32(), SCROLLED_FRAME_CRC32);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+Throughput(IN UNIT_TEST_CONTEXT Context)
+{
+  PFBCON_SHARED_STATE          State = FBCON_SHARED_STATE_ADDRESS;
+  HOST_CACHE_MAINTENANCE_STATS Stats;
+  CHAR8                        Line[81];
+  UINTN                        Index;
+  UINT64                       Start;
+  UINT64                       Nanoseconds;
+  UINT64                       Characters;
+  UINT64                       BytesPerLine;
+
+  //
+  // Log-like lines of 80 characters, each its own write as DebugLib does
+  //
+  SetMem(Line, sizeof(Line) - 1, 'A');
+  Line[sizeof(Line) - 2] = '\n';
+  Line[sizeof(Line) - 1] = '\0';
+
+  Start = GetPerformanceCounter();
+  for (Index = 0; Index < THROUGHPUT_LINES; Index++) {
+    Line[Index % 79] = 'a' + Index % 26;
+    WriteString(Line);
+  }
+  Nanoseconds = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+  Characters   = THROUGHPUT_LINES * (sizeof(Line) - 1);
+  BytesPerLine = State->CacheBytesCleaned / State->LinesRendered;
+  DEBUG(
+      (DEBUG_INFO, "FbCon: %lu characters in %lu us, %lu characters/s\n",
+       Characters, Nanoseconds / 1000,
+       Nanoseconds != 0 ? Characters * 1000000000 / Nanoseconds : 0));
+  DEBUG(
+      (DEBUG_INFO,
+       "FbCon: %lu cells drawn, %lu bytes of cache maintenance per line\n",
+       State->CellsDrawn, BytesPerLine));
+
+  UT_ASSERT_EQUAL(State->LinesRendered, THROUGHPUT_LINES);
+
+  //
+  // Every byte counted was asked of CacheMaintenanceLib, and nothing outside
+  // the framebuffer or the whole cache was
+  //
+  HostCacheMaintenanceGetStats(&Stats);
+  UT_ASSERT_EQUAL(Stats.RangeBytes, State->CacheBytesCleaned);
+  UT_ASSERT_EQUAL(Stats.WholeCacheCalls, 0);
+  UT_ASSERT_TRUE(
+      Stats.Lowest >= (UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress));
+  UT_ASSERT_TRUE(
+      Stats.Highest <=
+      (UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress) + FRAME_BUFFER_SIZE);
+
+  //
+  // Cleaning the whole panel for every line would be FRAME_BUFFER_SIZE;
+  // only the rows drawn, and each scroll's repaint spread over the lines
+  // that caused it, should be
+  //
+  UT_ASSERT_TRUE(BytesPerLine < FRAME_BUFFER_SIZE / 4);
+  UT_ASSERT_TRUE(ArmGetInterruptState());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Draw every glyph side by side in a row of 32bpp pixels Stride wide, and
+  return how long it took.
+**/
+STATIC
+UINT64
+DrawFont(
+    IN GLYPH_DRAW Draw, OUT UINT32 *Pixels, IN UINTN Stride, IN UINTN Scale)
+{
+  UINT64 Start;
+  UINTN  Glyph;
+
+  Start = GetPerformanceCounter();
+  for (Glyph = 0; Glyph < GLYPH_COUNT; Glyph++)
+    Draw(
+        (char *)(Pixels + Glyph * GLYPH_WIDTH * Scale), Stride, sizeof(UINT32),
+        font5x12 + Glyph * 2, Scale);
+  return GetPerformanceCounter() - Start;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+GlyphThroughput(IN UNIT_TEST_CONTEXT Context)
+{
+  UINT32 *Atlas;
+  UINT32 *PixelByPixel;
+  UINTN   Scale;
+  UINTN   Stride;
+  UINTN   Size;
+  UINTN   Round;
+  UINT64  AtlasTicks;
+  UINT64  PixelTicks;
+  UINT64  Glyphs;
+  BOOLEAN Same;
+
+  Glyphs = (UINT64)GLYPH_ROUNDS * GLYPH_COUNT;
+
+  //
+  // Every scale factor the atlas holds; larger ones always take the fallback
+  //
+  for (Scale = 1; Scale <= 4; Scale++) {
+    Stride       = GLYPH_COUNT * GLYPH_WIDTH * Scale;
+    Size         = Stride * GLYPH_HEIGHT * Scale * sizeof(UINT32);
+    Atlas        = AllocateZeroPool(Size);
+    PixelByPixel = AllocateZeroPool(Size);
+    UT_ASSERT_NOT_NULL(Atlas);
+    UT_ASSERT_NOT_NULL(PixelByPixel);
+
+    AtlasTicks = 0;
+    PixelTicks = 0;
+    for (Round = 0; Round < GLYPH_ROUNDS; Round++) {
+      AtlasTicks += DrawFont(FbConDrawglyph, Atlas, Stride, Scale);
+      PixelTicks += DrawFont(FbConDrawglyphPixels, PixelByPixel, Stride, Scale);
+    }
+
+    Same = CompareMem(Atlas, PixelByPixel, Size) == 0;
+    FreePool(Atlas);
+    FreePool(PixelByPixel);
+    UT_ASSERT_TRUE(Same);
+
+    AtlasTicks = GetTimeInNanoSecond(AtlasTicks);
+    PixelTicks = GetTimeInNanoSecond(PixelTicks);
+    DEBUG(
+        (DEBUG_INFO,
+         "FbCon: scale %lu: %lu glyphs/s from the atlas, %lu pixel by pixel\n",
+         (UINT64)Scale,
+         AtlasTicks != 0 ? Glyphs * 1000000000 / AtlasTicks : 0,
+         PixelTicks != 0 ? Glyphs * 1000000000 / PixelTicks : 0));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+EFI_STATUS
+EFIAPI
+UefiTestMain(VOID)
+{
+  EFI_STATUS                 Status;
+  UNIT_TEST_FRAMEWORK_HANDLE Framework;
+  UNIT_TEST_SUITE_HANDLE     Suite;
+
+  Framework = NULL;
+
+  DEBUG((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  if (HostFrameBufferMap() == NULL) {
+    DEBUG((DEBUG_ERROR, "Cannot map the framebuffer\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = InitUnitTestFramework(
+      &Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName,
+      UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR(Status)) {
+    DEBUG(
+        (DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n",
+         Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite(
+      &Suite, Framework, "Framebuffer console",
+      "ExynosPkg.FrameBufferSerialPortLib", NULL, NULL);
+  if (EFI_ERROR(Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase(
+      Suite, "Lines are drawn at a newline or a flush", "LinesRenderAtNewline",
+      LinesRenderAtNewline, ClearConsole, NULL, NULL);
+  AddTestCase(
+      Suite, "Critical output is drawn in yellow after queued output",
+      "CriticalOutputIsYellow", CriticalOutputIsYellow, ClearConsole, NULL,
+      NULL);
+  AddTestCase(
+      Suite, "Long lines wrap and the panel scrolls", "LongLinesWrapAndScroll",
+      LongLinesWrapAndScroll, ClearConsole, NULL, NULL);
+  AddTestCase(
+      Suite, "Characters per second and flush bytes per line", "Throughput",
+      Throughput, ClearConsole, NULL, NULL);
+  AddTestCase(
+      Suite, "Glyphs per second from the atlas and pixel by pixel",
+      "GlyphThroughput", GlyphThroughput, ClearConsole, NULL, NULL);
+
+  Status = RunAllTestSuites(Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework(Framework);
+  }
+
+  HostFrameBufferUnmap();
+  return Status;
+}
+
+int
+main(int argc, char *argv[])
+{
+  return UefiTestMain();
+}
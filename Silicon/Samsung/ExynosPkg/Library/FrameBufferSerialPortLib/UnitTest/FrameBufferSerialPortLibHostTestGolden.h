@@ -0,0 +1,223 @@
+/** @file
+  Golden images of FrameBufferSerialPortLibHostTest.c, in the format
+  HostFrameBufferLib.h describes. Produced by running the renderer and
+  checked by eye; a failing case prints its image in the same form.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _FRAME_BUFFER_SERIAL_PORT_LIB_HOST_TEST_GOLDEN_H_
+#define _FRAME_BUFFER_SERIAL_PORT_LIB_HOST_TEST_GOLDEN_H_
+
+// "Hello" drawn, "Wor" still queued
+STATIC CONST CHAR8 *CONST mHelloPending[] = {
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "##......##  ..........  ..####....  ..####....  ..........              ",
+    "##......##  ..........  ..####....  ..####....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..######..  ....##....  ....##....  ..######..              ",
+    "##......##  ..######..  ....##....  ....##....  ..######..              ",
+    "##########  ##......##  ....##....  ....##....  ##......##              ",
+    "##########  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ##########  ....##....  ....##....  ##......##              ",
+    "##......##  ##########  ....##....  ....##....  ##......##              ",
+    "##......##  ##........  ....##....  ....##....  ##......##              ",
+    "##......##  ##........  ....##....  ....##....  ##......##              ",
+    "##......##  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ..######..  ..######..  ..######..  ..######..              ",
+    "##......##  ..######..  ..######..  ..######..  ..######..              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+    "                                                                        ",
+};
+
+// After SerialPortFlush
+STATIC CONST CHAR8 *CONST mHelloFlushed[] = {
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "##......##  ..........  ..####....  ..####....  ..........              ",
+    "##......##  ..........  ..####....  ..####....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..........  ....##....  ....##....  ..........              ",
+    "##......##  ..######..  ....##....  ....##....  ..######..              ",
+    "##......##  ..######..  ....##....  ....##....  ..######..              ",
+    "##########  ##......##  ....##....  ....##....  ##......##              ",
+    "##########  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ##########  ....##....  ....##....  ##......##              ",
+    "##......##  ##########  ....##....  ....##....  ##......##              ",
+    "##......##  ##........  ....##....  ....##....  ##......##              ",
+    "##......##  ##........  ....##....  ....##....  ##......##              ",
+    "##......##  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ##......##  ....##....  ....##....  ##......##              ",
+    "##......##  ..######..  ..######..  ..######..  ..######..              ",
+    "##......##  ..######..  ..######..  ..######..  ..######..              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........                                      ",
+    "..........  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..........  ..........                                      ",
+    "##......##  ..######..  ##..####..                                      ",
+    "##......##  ..######..  ##..####..                                      ",
+    "##..##..##  ##......##  ####....##                                      ",
+    "##..##..##  ##......##  ####....##                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "##..##..##  ##......##  ##........                                      ",
+    "..##..##..  ..######..  ##........                                      ",
+    "..##..##..  ..######..  ##........                                      ",
+    "..........  ..........  ..........                                      ",
+    "..........  ..........  ..........                                      ",
+    "..........  ..........  ..........                                      ",
+    "..........  ..........  ..........                                      ",
+};
+
+// "ok " queued, then "FAIL" from SerialPortWriteCritical
+STATIC CONST CHAR8 *CONST mCritical[] = {
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "..........  ##........  ..........  YYYYYYYYYY  ....YY....  ..YYYYYY..  YY........              ",
+    "..........  ##........  ..........  YYYYYYYYYY  ....YY....  ..YYYYYY..  YY........              ",
+    "..........  ##........  ..........  YY........  ..YY..YY..  ....YY....  YY........              ",
+    "..........  ##........  ..........  YY........  ..YY..YY..  ....YY....  YY........              ",
+    "..........  ##........  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "..........  ##........  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "..######..  ##....##..  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "..######..  ##....##..  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "##......##  ##..##....  ..........  YYYYYYYY..  YY......YY  ....YY....  YY........              ",
+    "##......##  ##..##....  ..........  YYYYYYYY..  YY......YY  ....YY....  YY........              ",
+    "##......##  ####......  ..........  YY........  YYYYYYYYYY  ....YY....  YY........              ",
+    "##......##  ####......  ..........  YY........  YYYYYYYYYY  ....YY....  YY........              ",
+    "##......##  ##..##....  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "##......##  ##..##....  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "##......##  ##....##..  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "##......##  ##....##..  ..........  YY........  YY......YY  ....YY....  YY........              ",
+    "..######..  ##......##  ..........  YY........  YY......YY  ..YYYYYY..  YYYYYYYYYY              ",
+    "..######..  ##......##  ..........  YY........  YY......YY  ..YYYYYY..  YYYYYYYYYY              ",
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "..........  ..........  ..........  ..........  ..........  ..........  ..........              ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+    "                                                                                                ",
+};
+
+// Top left of the panel after LongLinesWrapAndScroll
+STATIC CONST CHAR8 *CONST mScrolledTop[] = {
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "....##....  ..######..  ..######..  ..........  ",
+    "....##....  ..######..  ..######..  ..........  ",
+    "..##..##..  ##......##  ##......##  ..........  ",
+    "..##..##..  ##......##  ##......##  ..........  ",
+    "##......##  ##........  ##........  ..........  ",
+    "##......##  ##........  ##........  ..........  ",
+    "##......##  ##........  ##........  ..........  ",
+    "##......##  ##........  ##........  ..........  ",
+    "##......##  ########..  ########..  ..........  ",
+    "##......##  ########..  ########..  ..........  ",
+    "##......##  ##......##  ##......##  ..........  ",
+    "##......##  ##......##  ##......##  ..........  ",
+    "##......##  ##......##  ##......##  ..........  ",
+    "##......##  ##......##  ##......##  ..........  ",
+    "..##..##..  ##......##  ##......##  ..........  ",
+    "..##..##..  ##......##  ##......##  ..........  ",
+    "....##....  ..######..  ..######..  ..........  ",
+    "....##....  ..######..  ..######..  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "##......##  ##......##  ##......##  ##......##  ",
+    "##......##  ##......##  ##......##  ##......##  ",
+    "..##..##..  ..##..##..  ..##..##..  ..##..##..  ",
+    "..##..##..  ..##..##..  ..##..##..  ..##..##..  ",
+    "....##....  ....##....  ....##....  ....##....  ",
+    "....##....  ....##....  ....##....  ....##....  ",
+    "....##....  ....##....  ....##....  ....##....  ",
+    "....##....  ....##....  ....##....  ....##....  ",
+    "..##..##..  ..##..##..  ..##..##..  ..##..##..  ",
+    "..##..##..  ..##..##..  ..##..##..  ..##..##..  ",
+    "##......##  ##......##  ##......##  ##......##  ",
+    "##......##  ##......##  ##......##  ##......##  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+    "..........  ..........  ..........  ..........  ",
+};
+
+// CalculateCrc32 of the whole panel after LongLinesWrapAndScroll
+#define SCROLLED_FRAME_CRC32 0xFF60E2BDU
+
+#endif
@@ -0,0 +1,331 @@
+/** @file
+  LZ4 GUIDED section extraction.
+
+  The section data is a little-endian UINT32 holding the decompressed size,
+  followed by one raw LZ4 block as written by tools/Lz4Compress.
+
+  With LZ4_MULTI_BLOCK set in the size, the data was compressed in
+  BlockSize pieces that do not refer to each other and PrePiMpLib decodes
+  them on all cores. A UINT32 BlockSize and the UINT32 compressed size of
+  every block come before the blocks themselves.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiPei.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+#include <Library/PrePiMpLib.h>
+
+#define LZ4_HEADER_SIZE sizeof(UINT32)
+#define LZ4_MIN_MATCH   4
+#define LZ4_MULTI_BLOCK BIT31
+
+typedef struct {
+  CONST UINT32    *PackedSizes;
+  CONST UINT8     *Blocks;
+  UINT8           *Destination;
+  UINTN            DestinationSize;
+  UINTN            BlockSize;
+  volatile BOOLEAN Corrupted;
+} LZ4_BLOCKS_JOB;
+
+STATIC
+RETURN_STATUS
+Lz4GetSectionData(
+    IN CONST VOID *InputSection, OUT CONST UINT8 **Data, OUT UINTN *DataSize,
+    OUT UINT16 *Attributes OPTIONAL)
+{
+  CONST EFI_GUID *Guid;
+  UINTN           DataOffset;
+  UINTN           SectionSize;
+
+  if (IS_SECTION2(InputSection)) {
+    Guid        = &((EFI_GUID_DEFINED_SECTION2 *)InputSection)->SectionDefinitionGuid;
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->DataOffset;
+    SectionSize = SECTION2_SIZE(InputSection);
+    if (Attributes != NULL)
+      *Attributes = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->Attributes;
+  }
+  else {
+    Guid        = &((EFI_GUID_DEFINED_SECTION *)InputSection)->SectionDefinitionGuid;
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION *)InputSection)->DataOffset;
+    SectionSize = SECTION_SIZE(InputSection);
+    if (Attributes != NULL)
+      *Attributes = ((EFI_GUID_DEFINED_SECTION *)InputSection)->Attributes;
+  }
+
+  if (!CompareGuid(Guid, &gExynosLz4CustomDecompressGuid))
+    return RETURN_INVALID_PARAMETER;
+
+  if (DataOffset > SectionSize ||
+      SectionSize - DataOffset < LZ4_HEADER_SIZE)
+    return RETURN_VOLUME_CORRUPTED;
+
+  *Data     = (CONST UINT8 *)InputSection + DataOffset;
+  *DataSize = SectionSize - DataOffset;
+  return RETURN_SUCCESS;
+}
+
+// Reads the 255-continued length extension that follows a nibble of 15
+STATIC
+BOOLEAN
+Lz4ReadLength(
+    IN OUT CONST UINT8 **Source, IN CONST UINT8 *SourceEnd,
+    IN OUT UINTN *Length)
+{
+  UINT8 Byte;
+
+  do {
+    if (*Source >= SourceEnd)
+      return FALSE;
+    Byte = *(*Source)++;
+    *Length += Byte;
+  } while (Byte == 255);
+
+  return TRUE;
+}
+
+STATIC
+RETURN_STATUS
+Lz4DecompressBlock(
+    IN CONST UINT8 *Source, IN UINTN SourceSize, OUT UINT8 *Destination,
+    IN UINTN DestinationSize)
+{
+  CONST UINT8 *SourceEnd = Source + SourceSize;
+  UINT8       *Output    = Destination;
+  UINT8       *OutputEnd = Destination + DestinationSize;
+  UINT8        Token;
+  UINTN        Length;
+  UINTN        Offset;
+  UINTN        Chunk;
+
+  while (Source < SourceEnd) {
+    Token = *Source++;
+
+    Length = Token >> 4;
+    if (Length == 15 && !Lz4ReadLength(&Source, SourceEnd, &Length))
+      return RETURN_VOLUME_CORRUPTED;
+
+    if (Length > (UINTN)(SourceEnd - Source) ||
+        Length > (UINTN)(OutputEnd - Output))
+      return RETURN_VOLUME_CORRUPTED;
+
+    CopyMem(Output, Source, Length);
+    Output += Length;
+    Source += Length;
+
+    // The last sequence is literals only
+    if (Source == SourceEnd)
+      break;
+
+    if (SourceEnd - Source < 2)
+      return RETURN_VOLUME_CORRUPTED;
+
+    Offset = Source[0] | ((UINTN)Source[1] << 8);
+    Source += 2;
+    if (Offset == 0 || Offset > (UINTN)(Output - Destination))
+      return RETURN_VOLUME_CORRUPTED;
+
+    Length = Token & 0xF;
+    if (Length == 15 && !Lz4ReadLength(&Source, SourceEnd, &Length))
+      return RETURN_VOLUME_CORRUPTED;
+    Length += LZ4_MIN_MATCH;
+
+    if (Length > (UINTN)(OutputEnd - Output))
+      return RETURN_VOLUME_CORRUPTED;
+
+    // Overlapping matches repeat the last Offset bytes; copy them a period
+    // at a time so no chunk reads bytes it is writing
+    if (Offset == 1) {
+      SetMem(Output, Length, Output[-1]);
+      Output += Length;
+    }
+    else {
+      while (Length > 0) {
+        Chunk = MIN(Length, Offset);
+        CopyMem(Output, Output - Offset, Chunk);
+        Output += Chunk;
+        Length -= Chunk;
+      }
+    }
+  }
+
+  return Output == OutputEnd ? RETURN_SUCCESS : RETURN_VOLUME_CORRUPTED;
+}
+
+STATIC
+VOID
+EFIAPI
+Lz4DecompressPiece(IN VOID *Context, IN UINTN Index)
+{
+  LZ4_BLOCKS_JOB *Job = Context;
+  CONST UINT8    *Source = Job->Blocks;
+  UINTN           Offset = Index * Job->BlockSize;
+  UINTN           Block;
+
+  // Few enough blocks that summing the sizes each time costs nothing
+  for (Block = 0; Block < Index; Block++)
+    Source += ReadUnaligned32(&Job->PackedSizes[Block]);
+
+  if (RETURN_ERROR(Lz4DecompressBlock(
+          Source, ReadUnaligned32(&Job->PackedSizes[Index]),
+          Job->Destination + Offset,
+          MIN(Job->BlockSize, Job->DestinationSize - Offset))))
+    Job->Corrupted = TRUE;
+}
+
+STATIC
+RETURN_STATUS
+Lz4DecompressBlocks(
+    IN CONST UINT8 *Source, IN UINTN SourceSize, OUT UINT8 *Destination,
+    IN UINTN DestinationSize)
+{
+  LZ4_BLOCKS_JOB Job;
+  UINTN          BlockCount;
+  UINTN          Packed;
+  UINTN          Index;
+
+  if (SourceSize < sizeof(UINT32))
+    return RETURN_VOLUME_CORRUPTED;
+
+  Job.BlockSize = ReadUnaligned32((CONST UINT32 *)Source);
+  if (Job.BlockSize == 0)
+    return RETURN_VOLUME_CORRUPTED;
+
+  BlockCount = (DestinationSize + Job.BlockSize - 1) / Job.BlockSize;
+  Source     += sizeof(UINT32);
+  SourceSize -= sizeof(UINT32);
+  if (SourceSize / sizeof(UINT32) < BlockCount)
+    return RETURN_VOLUME_CORRUPTED;
+
+  Job.PackedSizes     = (CONST UINT32 *)Source;
+  Job.Blocks          = Source + BlockCount * sizeof(UINT32);
+  Job.Destination     = Destination;
+  Job.DestinationSize = DestinationSize;
+  Job.Corrupted       = FALSE;
+
+  Packed = 0;
+  for (Index = 0; Index < BlockCount; Index++)
+    Packed += ReadUnaligned32(&Job.PackedSizes[Index]);
+  if (Packed != SourceSize - BlockCount * sizeof(UINT32))
+    return RETURN_VOLUME_CORRUPTED;
+
+  PrePiMpRun(Lz4DecompressPiece, &Job, BlockCount);
+
+  return Job.Corrupted ? RETURN_VOLUME_CORRUPTED : RETURN_SUCCESS;
+}
+
+/**
+  Examines a GUIDED section and returns the size of the decoded buffer and
+  the size of an optional scratch buffer required to actually decode the
+  data in a GUIDED section.
+
+  @param[in]  InputSection       A pointer to a GUIDED section of an FFS
+                                 formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output
+                                 buffer required if the buffer specified by
+                                 InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as
+                                 scratch space if the buffer specified by
+                                 InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDED
+                                 section.
+
+  @retval RETURN_SUCCESS            The information about InputSection was
+                                    returned.
+  @retval RETURN_INVALID_PARAMETER  The section specified by InputSection does
+                                    not match the GUID this handler supports.
+  @retval RETURN_VOLUME_CORRUPTED   The section is too small for the header.
+**/
+RETURN_STATUS
+EFIAPI
+Lz4GuidedSectionGetInfo(
+    IN CONST VOID *InputSection, OUT UINT32 *OutputBufferSize,
+    OUT UINT32 *ScratchBufferSize, OUT UINT16 *SectionAttribute)
+{
+  RETURN_STATUS Status;
+  CONST UINT8  *Data;
+  UINTN         DataSize;
+
+  ASSERT(InputSection != NULL);
+  ASSERT(OutputBufferSize != NULL);
+  ASSERT(ScratchBufferSize != NULL);
+  ASSERT(SectionAttribute != NULL);
+
+  Status = Lz4GetSectionData(InputSection, &Data, &DataSize, SectionAttribute);
+  if (RETURN_ERROR(Status))
+    return Status;
+
+  *OutputBufferSize  = ReadUnaligned32((CONST UINT32 *)Data) & ~LZ4_MULTI_BLOCK;
+  *ScratchBufferSize = 0;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress an LZ4 encoded GUIDED section into a caller allocated output
+  buffer.
+
+  @param[in]  InputSection          A pointer to a GUIDED section of an FFS
+                                    formatted file.
+  @param[out] OutputBuffer          A pointer to a buffer that contains the
+                                    result of a decode operation.
+  @param[in]  ScratchBuffer         Not used, LZ4 needs no scratch space.
+  @param[out] AuthenticationStatus  Always 0, the section is not signed.
+
+  @retval RETURN_SUCCESS            The buffer specified by InputSection was
+                                    decoded.
+  @retval RETURN_INVALID_PARAMETER  The section specified by InputSection does
+                                    not match the GUID this handler supports.
+  @retval RETURN_VOLUME_CORRUPTED   An LZ4 block is malformed.
+**/
+RETURN_STATUS
+EFIAPI
+Lz4GuidedSectionExtraction(
+    IN CONST VOID *InputSection, OUT VOID **OutputBuffer,
+    OUT VOID *ScratchBuffer OPTIONAL, OUT UINT32 *AuthenticationStatus)
+{
+  RETURN_STATUS Status;
+  CONST UINT8  *Data;
+  UINTN         DataSize;
+  UINT32        Size;
+
+  ASSERT(OutputBuffer != NULL);
+  ASSERT(*OutputBuffer != NULL);
+  ASSERT(AuthenticationStatus != NULL);
+
+  Status = Lz4GetSectionData(InputSection, &Data, &DataSize, NULL);
+  if (RETURN_ERROR(Status))
+    return Status;
+
+  *AuthenticationStatus = 0;
+
+  Size = ReadUnaligned32((CONST UINT32 *)Data);
+  if ((Size & LZ4_MULTI_BLOCK) != 0)
+    return Lz4DecompressBlocks(
+        Data + LZ4_HEADER_SIZE, DataSize - LZ4_HEADER_SIZE, *OutputBuffer,
+        Size & ~LZ4_MULTI_BLOCK);
+
+  return Lz4DecompressBlock(
+      Data + LZ4_HEADER_SIZE, DataSize - LZ4_HEADER_SIZE, *OutputBuffer,
+      Size);
+}
+
+/**
+  Register the LZ4 handler with the ExtractGuidedSectionLib of the module
+  it is linked into.
+
+  @retval RETURN_SUCCESS            Registration succeeded.
+  @retval RETURN_OUT_OF_RESOURCES   No more handlers can be registered.
+**/
+RETURN_STATUS
+EFIAPI
+Lz4DecompressLibConstructor(VOID)
+{
+  return ExtractGuidedSectionRegisterHandlers(
+      &gExynosLz4CustomDecompressGuid, Lz4GuidedSectionGetInfo,
+      Lz4GuidedSectionExtraction);
+}
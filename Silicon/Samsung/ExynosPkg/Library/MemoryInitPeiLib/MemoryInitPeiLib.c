@@ -9,14 +9,19 @@
 #define FDT_DIRECT
 #include <PiPei.h>
 
+#include <Chipset/AArch64.h>
+#include <Library/ArmLib.h>
 #include <Library/ArmMmuLib.h>
 #include <Library/ArmPlatformLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/HobLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/FdtParserLib.h>
 #include <Library/PlatformMemoryMapLib.h>
+#include <Library/TimerLib.h>
 
 #define SIZE_KB ((UINTN)(1024))
 #define SIZE_MB ((UINTN)(SIZE_KB * 1024))
@@ -31,25 +36,81 @@ extern UINT64 mSystemMemoryEnd;
 
 VOID BuildMemoryTypeInformationHob(VOID);
 
+typedef struct {
+  UINTN TablePages;
+  UINTN Mappings[4];
+} MMU_TABLE_WALK;
 
+/**
+  Count the table pages and the 1G, 2M and 4K mappings ArmConfigureMmu
+  built, to see what merging the regions saved.
+**/
 STATIC
-VOID InitMmu(IN ARM_MEMORY_REGION_DESCRIPTOR *MemoryTable)
+VOID
+CountTranslationTable(
+    IN UINT64 *Table, IN UINTN Level, IN UINTN EntryCount,
+    IN OUT MMU_TABLE_WALK *Walk)
 {
+  UINT64 BlockType =
+      Level == 3 ? TT_TYPE_BLOCK_ENTRY_LEVEL3 : TT_TYPE_BLOCK_ENTRY;
+  UINTN  Index;
+
+  Walk->TablePages++;
 
-  VOID *        TranslationTableBase;
-  UINTN         TranslationTableSize;
-  RETURN_STATUS Status;
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Level < 3 && (Table[Index] & TT_TYPE_MASK) == TT_TYPE_TABLE_ENTRY) {
+      CountTranslationTable(
+          (UINT64 *)(UINTN)(Table[Index] & TT_ADDRESS_MASK_DESCRIPTION_TABLE),
+          Level + 1, TT_ENTRY_COUNT, Walk);
+    }
+    else if (Level > 0 && (Table[Index] & TT_TYPE_MASK) == BlockType) {
+      Walk->Mappings[Level]++;
+    }
+  }
+}
+
+STATIC
+VOID InitMmu(
+    IN ARM_MEMORY_REGION_DESCRIPTOR *MemoryTable, IN UINTN Regions,
+    IN UINTN Merged)
+{
+
+  VOID *         TranslationTableBase;
+  UINTN          TranslationTableSize;
+  RETURN_STATUS  Status;
+  MMU_TABLE_WALK Walk;
+  UINTN          T0SZ;
+  UINT64         Start;
+  UINT64         Built;
 
   // Note: Because we called PeiServicesInstallPeiMemory() before
   // to call InitMmu() the MMU Page Table resides in
   // RAM (even at the top of DRAM as it is the first permanent memory
   // allocation)
+  Start  = GetPerformanceCounter();
   Status = ArmConfigureMmu(
       MemoryTable, &TranslationTableBase, &TranslationTableSize);
+  Built = GetPerformanceCounter();
 
   if (EFI_ERROR(Status)) {
     DEBUG((EFI_D_ERROR, "Error: Failed to enable MMU: %r\n", Status));
+    return;
   }
+
+  ZeroMem(&Walk, sizeof(Walk));
+
+  // Root level and size follow from T0SZ as in ArmMmuLib
+  T0SZ = ArmGetTCR() & 0x3F;
+  CountTranslationTable(
+      TranslationTableBase, (T0SZ - 16) / 9, 1UL << (9 - (T0SZ - 16) % 9),
+      &Walk);
+
+  DEBUG(
+      (EFI_D_INFO,
+       "MMU: %lu regions (%lu merged), %lu table pages, %lu/%lu/%lu 1G/2M/4K "
+       "mappings; built in %lu us\n",
+       Regions, Merged, Walk.TablePages, Walk.Mappings[1], Walk.Mappings[2],
+       Walk.Mappings[3], DivU64x32(GetTimeInNanoSecond(Built - Start), 1000)));
 }
 
 STATIC
@@ -91,6 +152,7 @@ MemoryPeim(IN EFI_PHYSICAL_ADDRESS UefiMemoryBase, IN UINT64 UefiMemorySize)
   ARM_MEMORY_REGION_DESCRIPTOR
         MemoryDescriptor[MAX_ARM_MEMORY_REGION_DESCRIPTOR_COUNT];
   UINTN Index = 0;
+  UINTN Merged = 0;
   UINTN Node = 0;
   UINTN MemoryBase = 0;
   UINTN MemorySize = 0;
@@ -129,6 +191,20 @@ MemoryPeim(IN EFI_PHYSICAL_ADDRESS UefiMemoryBase, IN UINT64 UefiMemorySize)
     }
 
   update:
+    // Neighbours with the same attributes map as one region, so the seam
+    // between them does not force smaller blocks
+    if (Index > 0 &&
+        MemoryDescriptor[Index - 1].PhysicalBase +
+                MemoryDescriptor[Index - 1].Length ==
+            MemoryDescriptorEx->Address &&
+        MemoryDescriptor[Index - 1].Attributes ==
+            MemoryDescriptorEx->ArmAttributes) {
+      MemoryDescriptor[Index - 1].Length += MemoryDescriptorEx->Length;
+      Merged++;
+      MemoryDescriptorEx++;
+      continue;
+    }
+
     ASSERT(Index < MAX_ARM_MEMORY_REGION_DESCRIPTOR_COUNT);
 
     MemoryDescriptor[Index].PhysicalBase = MemoryDescriptorEx->Address;
@@ -149,7 +225,7 @@ MemoryPeim(IN EFI_PHYSICAL_ADDRESS UefiMemoryBase, IN UINT64 UefiMemorySize)
 
   // Build Memory Allocation Hob
   DEBUG((EFI_D_INFO, "\nConfigure MMU In \n"));
-  InitMmu(MemoryDescriptor);
+  InitMmu(MemoryDescriptor, Index, Merged);
   DEBUG((EFI_D_INFO, "Configure MMU Out \n"));
 
   if (FeaturePcdGet(PcdPrePiProduceMemoryTypeInformationHob)) {
@@ -0,0 +1,270 @@
+/** @file
+  Runs PrePi work on the secondary cores.
+
+  A job is split into Count pieces and slot N of K takes pieces N, N + K,
+  ... so no core needs atomics, which are not guaranteed to work on the
+  Device memory every access goes to while the MMU is off. Secondaries are
+  powered on with PSCI CPU_ON for each job. They take over the boot core's
+  MMU setup, if it has one yet, and power themselves off with CPU_OFF
+  once their share is done.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiPei.h>
+#include <IndustryStandard/ArmStdSmc.h>
+
+#include <Library/ArmHvcLib.h>
+#include <Library/ArmLib.h>
+#include <Library/ArmSmcLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PlatformMemoryMapLib.h>
+#include <Library/TimerLib.h>
+
+#include "PrePiMpLibInternal.h"
+
+typedef struct {
+  UINT8 *Buffer;
+  UINTN  Length;
+} PREPI_MP_ZERO_JOB;
+
+// Read by PrePiMpSecondaryEntry with the MMU off
+PREPI_MP_CONTEXT gPrePiMpContext;
+
+STATIC PREPI_MP_BATCH mBatch;
+
+// MPIDR of the core in each slot, slot 0 is the boot core. mSlots stays
+// 0 until the first job looks for cores.
+STATIC UINT64 mSlotMpidr[PREPI_MP_MAX_CORES];
+STATIC UINTN  mSlots;
+
+STATIC UINTN  mJobs;
+STATIC UINTN  mPieces;
+STATIC UINT64 mJobTicks;
+
+STATIC
+INTN
+PsciCall(
+  IN UINTN FunctionId,
+  IN UINTN Arg1,
+  IN UINTN Arg2,
+  IN UINTN Arg3
+  )
+{
+  ARM_SMC_ARGS SmcArgs;
+  ARM_HVC_ARGS HvcArgs;
+
+  if (FeaturePcdGet (PcdPsciConduitHvc)) {
+    ZeroMem (&HvcArgs, sizeof (HvcArgs));
+    HvcArgs.Arg0 = FunctionId;
+    HvcArgs.Arg1 = Arg1;
+    HvcArgs.Arg2 = Arg2;
+    HvcArgs.Arg3 = Arg3;
+    ArmCallHvc (&HvcArgs);
+    return (INTN)HvcArgs.Arg0;
+  }
+
+  ZeroMem (&SmcArgs, sizeof (SmcArgs));
+  SmcArgs.Arg0 = FunctionId;
+  SmcArgs.Arg1 = Arg1;
+  SmcArgs.Arg2 = Arg2;
+  SmcArgs.Arg3 = Arg3;
+  ArmCallSmc (&SmcArgs);
+  return (INTN)SmcArgs.Arg0;
+}
+
+// Slots go to the cores PSCI reports off, the bootloader may have left
+// others running
+STATIC
+VOID
+FindCores(VOID)
+{
+  UINT64 *CoreMap;
+  UINTN   CoreCount;
+  UINTN   Index;
+
+  mSlotMpidr[0] = ArmReadMpidr () & MPIDR_AFFINITY_MASK;
+  mSlots        = 1;
+
+  ASSERT (PREPI_MP_MAX_CORES * PREPI_MP_STACK_SIZE <=
+          FixedPcdGet32 (PcdPrePiStackSize) / 2);
+
+  CoreMap = GetPlatformCoreMap (&CoreCount);
+  for (Index = 0; Index < CoreCount && mSlots < PREPI_MP_MAX_CORES; Index++) {
+    if (CoreMap[Index] == mSlotMpidr[0]) {
+      continue;
+    }
+
+    if (PsciCall (ARM_SMC_ID_PSCI_AFFINITY_INFO_AARCH64,
+                  CoreMap[Index], 0, 0) == PSCI_AFFINITY_OFF) {
+      mSlotMpidr[mSlots++] = CoreMap[Index];
+    }
+  }
+}
+
+// A core reports done just before CPU_OFF, it may still be going down
+STATIC
+VOID
+WaitForCoreOff(
+  IN UINTN Slot
+  )
+{
+  UINTN Retries;
+
+  for (Retries = 0; Retries < PREPI_MP_OFF_RETRIES; Retries++) {
+    if (PsciCall (ARM_SMC_ID_PSCI_AFFINITY_INFO_AARCH64,
+                  mSlotMpidr[Slot], 0, 0) == PSCI_AFFINITY_OFF) {
+      return;
+    }
+    MicroSecondDelay (PREPI_MP_OFF_POLL_US);
+  }
+}
+
+STATIC
+VOID
+RunShare(
+  IN UINTN Slot
+  )
+{
+  UINTN Index;
+
+  for (Index = Slot; Index < mBatch.Count; Index += mBatch.Stride) {
+    mBatch.Job (mBatch.Context, Index);
+  }
+}
+
+// Runs on a secondary core once it has the boot core's setup and a stack
+VOID
+EFIAPI
+PrePiMpSecondaryMain(
+  IN UINTN Slot
+  )
+{
+  RunShare (Slot);
+
+  // Everything the pieces wrote must land before the boot core sees done
+  ArmDataSynchronizationBarrier ();
+  mBatch.Done[Slot] = 1;
+  ArmDataSynchronizationBarrier ();
+
+  PsciCall (ARM_SMC_ID_PSCI_CPU_OFF, 0, 0, 0);
+
+  // CPU_OFF only returns on failure
+  CpuDeadLoop ();
+}
+
+VOID
+EFIAPI
+PrePiMpRun(
+  IN PREPI_MP_JOB Job,
+  IN VOID        *Context,
+  IN UINTN        Count
+  )
+{
+  UINT64  StartTicks;
+  UINTN   Slot;
+  UINTN   Used;
+  BOOLEAN Started[PREPI_MP_MAX_CORES];
+
+  if (mSlots == 0) {
+    FindCores ();
+  }
+
+  StartTicks = GetPerformanceCounter ();
+
+  Used = MIN (mSlots, Count);
+  mBatch.Job     = Job;
+  mBatch.Context = Context;
+  mBatch.Count   = Count;
+  mBatch.Stride  = Used;
+  for (Slot = 0; Slot < PREPI_MP_MAX_CORES; Slot++) {
+    mBatch.Done[Slot] = 0;
+  }
+
+  PrePiMpCaptureContext (&gPrePiMpContext);
+  gPrePiMpContext.StacksBase = FixedPcdGet32 (PcdPrePiStackBase);
+  gPrePiMpContext.StackSize  = PREPI_MP_STACK_SIZE;
+
+  // Secondaries read the context before their caches are on
+  WriteBackDataCacheRange (&gPrePiMpContext, sizeof (gPrePiMpContext));
+  ArmDataSynchronizationBarrier ();
+
+  for (Slot = 1; Slot < Used; Slot++) {
+    WaitForCoreOff (Slot);
+    Started[Slot] = PsciCall (
+                      ARM_SMC_ID_PSCI_CPU_ON_AARCH64, mSlotMpidr[Slot],
+                      (UINTN)PrePiMpSecondaryEntry, Slot) == ARM_SMC_PSCI_RET_SUCCESS;
+  }
+
+  RunShare (0);
+
+  // The boot core takes over the share of any core that did not start
+  for (Slot = 1; Slot < Used; Slot++) {
+    if (!Started[Slot]) {
+      RunShare (Slot);
+      continue;
+    }
+
+    while (mBatch.Done[Slot] == 0) {
+      CpuPause ();
+    }
+  }
+
+  ArmDataMemoryBarrier ();
+
+  mJobs++;
+  mPieces   += Count;
+  mJobTicks += GetPerformanceCounter () - StartTicks;
+}
+
+STATIC
+VOID
+EFIAPI
+ZeroPiece(
+  IN VOID *Context,
+  IN UINTN Index
+  )
+{
+  PREPI_MP_ZERO_JOB *Job;
+  UINTN              Offset;
+
+  Job    = Context;
+  Offset = Index * PREPI_MP_ZERO_CHUNK;
+  ZeroMem (Job->Buffer + Offset, MIN (PREPI_MP_ZERO_CHUNK, Job->Length - Offset));
+}
+
+VOID
+EFIAPI
+PrePiMpZeroMem(
+  OUT VOID *Buffer,
+  IN  UINTN Length
+  )
+{
+  PREPI_MP_ZERO_JOB Job;
+
+  Job.Buffer = Buffer;
+  Job.Length = Length;
+  PrePiMpRun (
+      ZeroPiece, &Job,
+      (Length + PREPI_MP_ZERO_CHUNK - 1) / PREPI_MP_ZERO_CHUNK);
+}
+
+VOID
+EFIAPI
+PrePiMpPark(VOID)
+{
+  UINTN Slot;
+
+  for (Slot = 1; Slot < mSlots; Slot++) {
+    WaitForCoreOff (Slot);
+  }
+
+  DEBUG((
+      EFI_D_INFO, "PrePiMp: %lu jobs, %lu pieces on %lu cores in %lu us\n",
+      mJobs, mPieces, mSlots,
+      DivU64x32 (GetTimeInNanoSecond (mJobTicks), 1000)));
+}
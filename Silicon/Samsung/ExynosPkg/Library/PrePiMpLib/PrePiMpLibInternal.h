@@ -0,0 +1,56 @@
+#ifndef _PREPI_MP_LIB_INTERNAL_H_
+#define _PREPI_MP_LIB_INTERNAL_H_
+
+#include <Library/PrePiMpLib.h>
+
+// Secondary stacks are carved from the bottom of the PrePi stack
+#define PREPI_MP_MAX_CORES      8
+#define PREPI_MP_STACK_SIZE     SIZE_8KB
+
+// Pieces PrePiMpZeroMem splits a buffer into
+#define PREPI_MP_ZERO_CHUNK     SIZE_1MB
+
+// How long to wait for a core that just finished to report itself off
+#define PREPI_MP_OFF_POLL_US    10
+#define PREPI_MP_OFF_RETRIES    10000
+
+// PSCI AFFINITY_INFO return value for a core that is off
+#define PSCI_AFFINITY_OFF       1
+
+#define MPIDR_AFFINITY_MASK     0xFF00FFFFFFULL
+
+// The boot core's setup, loaded by PrePiMpSecondaryEntry before anything
+// else. The offsets are hardcoded in AArch64/PrePiMpEntry.S.
+typedef struct {
+  UINT64 Mair;          // 0x00
+  UINT64 Tcr;           // 0x08
+  UINT64 Ttbr0;         // 0x10
+  UINT64 Sctlr;         // 0x18, MMU off while PrePi has not built tables yet
+  UINT64 Vbar;          // 0x20
+  UINT64 Hcr;           // 0x28, EL2 only
+  UINT64 StacksBase;    // 0x30
+  UINT64 StackSize;     // 0x38
+} PREPI_MP_CONTEXT;
+
+typedef struct {
+  PREPI_MP_JOB     Job;
+  VOID            *Context;
+  UINTN            Count;
+  // Slot N runs pieces N, N + Stride, ...
+  UINTN            Stride;
+  volatile UINT32  Done[PREPI_MP_MAX_CORES];
+} PREPI_MP_BATCH;
+
+// Started by PSCI CPU_ON with the MMU off and the slot in x0
+VOID
+PrePiMpSecondaryEntry (
+  VOID
+  );
+
+// Saves the translation regime of the calling core
+VOID
+PrePiMpCaptureContext (
+  OUT PREPI_MP_CONTEXT *Context
+  );
+
+#endif /* _PREPI_MP_LIB_INTERNAL_H_ */
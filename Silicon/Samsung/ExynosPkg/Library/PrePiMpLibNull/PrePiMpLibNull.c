@@ -0,0 +1,41 @@
+/** @file
+  PrePiMpLib that runs every job on the calling core.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Base.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/PrePiMpLib.h>
+
+VOID
+EFIAPI
+PrePiMpRun(
+  IN PREPI_MP_JOB Job,
+  IN VOID        *Context,
+  IN UINTN        Count
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Job (Context, Index);
+  }
+}
+
+VOID
+EFIAPI
+PrePiMpZeroMem(
+  OUT VOID *Buffer,
+  IN  UINTN Length
+  )
+{
+  ZeroMem (Buffer, Length);
+}
+
+VOID
+EFIAPI
+PrePiMpPark(VOID)
+{
+}
@@ -0,0 +1,216 @@
+// FvCache.c: Reuse the FV a previous boot decompressed, see Configuration/FvCache.h
+
+#include <PiPei.h>
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrePiLib.h>
+#include <Library/TimerLib.h>
+
+#include <Configuration/FvCache.h>
+
+#include "Pi.h"
+
+#define FV_CACHE_ADDRESS                                                       \
+  ((PFV_CACHE_HEADER)(UINTN)FixedPcdGet64(PcdFvCacheBase))
+
+STATIC_ASSERT(
+    FV_CACHE_DIGEST_SIZE == SHA256_DIGEST_SIZE,
+    "FV_CACHE_DIGEST_SIZE is not the size of a SHA-256 digest");
+
+STATIC CONST EFI_GUID mDigestFileGuid = FV_CACHE_DIGEST_FILE_GUID;
+
+// The FV image file in the FD and the digest the FD has for the FV in it,
+// found by FvCacheRestore
+STATIC EFI_FFS_FILE_HEADER *mSourceFile;
+STATIC UINT8 *              mDigest;
+
+STATIC
+BOOLEAN
+FvCacheEnabled(VOID)
+{
+  return FeaturePcdGet(PcdFvCacheEnable) &&
+         FixedPcdGet64(PcdFvCacheBase) != 0 &&
+         FixedPcdGet32(PcdFvCacheSize) > FV_CACHE_DATA_OFFSET;
+}
+
+STATIC
+UINT32
+FvCacheHeaderCrc(PFV_CACHE_HEADER Cache)
+{
+  FV_CACHE_HEADER Header;
+
+  CopyMem(&Header, Cache, sizeof(Header));
+  Header.HeaderCrc = 0;
+  return CalculateCrc32(&Header, sizeof(Header));
+}
+
+STATIC
+EFI_STATUS
+FvCacheFindSource(VOID)
+{
+  STATIC CONST UINT8  Unstamped[FV_CACHE_DIGEST_SIZE] = {0};
+  EFI_STATUS          Status;
+  EFI_PEI_FV_HANDLE   VolumeHandle;
+  EFI_PEI_FILE_HANDLE FileHandle;
+  EFI_PEI_FILE_HANDLE DigestHandle;
+  EFI_RAW_SECTION *   Section;
+
+  // The same file DecompressFirstFv extracts
+  VolumeHandle = NULL;
+  Status       = FfsAnyFvFindFirstFile(
+      EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE, &VolumeHandle, &FileHandle);
+  if (EFI_ERROR(Status))
+    return Status;
+
+  // Next to it in FVMAIN_COMPACT
+  Status = FfsFindFileByName(&mDigestFileGuid, VolumeHandle, &DigestHandle);
+  if (EFI_ERROR(Status))
+    return Status;
+
+  // A single RAW section holding the digest, see the FDFs
+  Section = (EFI_RAW_SECTION *)((EFI_FFS_FILE_HEADER *)DigestHandle + 1);
+  if (FFS_FILE_SIZE(DigestHandle) < sizeof(EFI_FFS_FILE_HEADER) +
+                                        sizeof(*Section) +
+                                        FV_CACHE_DIGEST_SIZE ||
+      Section->Type != EFI_SECTION_RAW ||
+      SECTION_SIZE(Section) != sizeof(*Section) + FV_CACHE_DIGEST_SIZE)
+    return EFI_VOLUME_CORRUPTED;
+
+  // build.sh did not run tools/FvCacheDigest on this FD
+  if (CompareMem(Section + 1, Unstamped, sizeof(Unstamped)) == 0) {
+    DEBUG((EFI_D_WARN, "FvCache: FD has no FVMAIN digest\n"));
+    return EFI_NOT_FOUND;
+  }
+
+  mSourceFile = FileHandle;
+  mDigest     = (UINT8 *)(Section + 1);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+FvCacheCheck(PFV_CACHE_HEADER Cache)
+{
+  EFI_FIRMWARE_VOLUME_HEADER *Fv = (VOID *)FV_CACHE_DATA(Cache);
+  UINT8                       Digest[SHA256_DIGEST_SIZE];
+
+  // A cold boot or a torn save
+  if (Cache->Signature != FV_CACHE_SIGNATURE ||
+      Cache->HeaderCrc != FvCacheHeaderCrc(Cache))
+    return EFI_NOT_FOUND;
+
+  // New firmware since the FV was cached, no need to hash it
+  if (CompareMem(Cache->Digest, mDigest, FV_CACHE_DIGEST_SIZE) != 0 ||
+      !CompareGuid(&Cache->FileName, &mSourceFile->Name))
+    return EFI_NOT_FOUND;
+
+  if (Cache->FvLength >
+          FixedPcdGet32(PcdFvCacheSize) - FV_CACHE_DATA_OFFSET ||
+      Fv->Signature != EFI_FVH_SIGNATURE || Fv->FvLength != Cache->FvLength)
+    return EFI_VOLUME_CORRUPTED;
+
+  // The only check that matters, see the trust model in FvCache.h. The
+  // header is just as writable as the FV, so compare with the FD.
+  if (!Sha256HashAll(Fv, Cache->FvLength, Digest))
+    return EFI_DEVICE_ERROR;
+
+  if (CompareMem(Digest, mDigest, FV_CACHE_DIGEST_SIZE) != 0)
+    return EFI_SECURITY_VIOLATION;
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+FvCacheRestore(VOID)
+{
+  PFV_CACHE_HEADER Cache = FV_CACHE_ADDRESS;
+  EFI_STATUS       Status;
+  UINT64           StartTicks;
+
+  if (!FvCacheEnabled())
+    return EFI_UNSUPPORTED;
+
+  StartTicks = GetPerformanceCounter();
+
+  Status = FvCacheFindSource();
+  if (EFI_ERROR(Status))
+    return Status;
+
+  Status = FvCacheCheck(Cache);
+  if (EFI_ERROR(Status)) {
+    DEBUG((EFI_D_INFO, "FvCache: %r, decompressing\n", Status));
+    return Status;
+  }
+
+  // What FfsProcessFvFile would have published for the extracted copy
+  BuildFvHob((EFI_PHYSICAL_ADDRESS)(UINTN)FV_CACHE_DATA(Cache), Cache->FvLength);
+  BuildFv2Hob(
+      (EFI_PHYSICAL_ADDRESS)(UINTN)FV_CACHE_DATA(Cache), Cache->FvLength,
+      &Cache->FvName, &Cache->FileName);
+
+  DEBUG(
+      (EFI_D_INFO, "FvCache: reused 0x%lx byte FV in %lu us\n",
+       Cache->FvLength,
+       DivU64x32(
+           GetTimeInNanoSecond(GetPerformanceCounter() - StartTicks), 1000)));
+  return EFI_SUCCESS;
+}
+
+VOID FvCacheSave(VOID)
+{
+  PFV_CACHE_HEADER            Cache = FV_CACHE_ADDRESS;
+  EFI_PEI_HOB_POINTERS        Hob;
+  EFI_FIRMWARE_VOLUME_HEADER *Fv;
+  UINT64                      StartTicks;
+
+  if (!FvCacheEnabled() || mSourceFile == NULL)
+    return;
+
+  StartTicks = GetPerformanceCounter();
+
+  for (Hob.Raw = GetHobList();
+       (Hob.Raw = GetNextHob(EFI_HOB_TYPE_FV2, Hob.Raw)) != NULL;
+       Hob.Raw = GET_NEXT_HOB(Hob)) {
+    if (CompareGuid(&Hob.FirmwareVolume2->FileName, &mSourceFile->Name))
+      break;
+  }
+
+  if (Hob.Raw == NULL)
+    return;
+
+  Fv = (EFI_FIRMWARE_VOLUME_HEADER *)(UINTN)Hob.FirmwareVolume2->BaseAddress;
+  if (Fv->FvLength > FixedPcdGet32(PcdFvCacheSize) - FV_CACHE_DATA_OFFSET) {
+    DEBUG(
+        (EFI_D_WARN, "FvCache: 0x%lx byte FV does not fit in 0x%x bytes\n",
+         Fv->FvLength, FixedPcdGet32(PcdFvCacheSize)));
+    return;
+  }
+
+  // A reset in the middle of the copy must not leave a valid header behind
+  Cache->Signature = 0;
+  WriteBackDataCacheRange(Cache, sizeof(*Cache));
+
+  CopyMem(FV_CACHE_DATA(Cache), Fv, Fv->FvLength);
+
+  ZeroMem(Cache, sizeof(*Cache));
+  Cache->FvLength = Fv->FvLength;
+  CopyMem(Cache->Digest, mDigest, FV_CACHE_DIGEST_SIZE);
+  CopyGuid(&Cache->FvName, &Hob.FirmwareVolume2->FvName);
+  CopyGuid(&Cache->FileName, &Hob.FirmwareVolume2->FileName);
+  Cache->Signature = FV_CACHE_SIGNATURE;
+  Cache->HeaderCrc = FvCacheHeaderCrc(Cache);
+
+  // A warm reset does not write back the data cache
+  WriteBackDataCacheRange(Cache, FV_CACHE_DATA_OFFSET + Fv->FvLength);
+
+  DEBUG(
+      (EFI_D_INFO, "FvCache: saved 0x%lx byte FV in %lu us\n", Fv->FvLength,
+       DivU64x32(
+           GetTimeInNanoSecond(GetPerformanceCounter() - StartTicks), 1000)));
+}
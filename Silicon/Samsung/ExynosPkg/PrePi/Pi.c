@@ -7,8 +7,12 @@
 #include <Library/PrintLib.h>
 #include <Library/PrePiHobListPointerLib.h>
 #include <Library/CacheMaintenanceLib.h>
+#include <Library/PerformanceLib.h>
 #include <Library/PlatformPrePiLib.h>
+#include <Library/PrePiMpLib.h>
+#include <Library/TimerLib.h>
 
+#include <Guid/FirmwarePerformance.h>
 #include <Ppi/GuidedSectionExtraction.h>
 
 #include "Pi.h"
@@ -19,17 +23,69 @@
 UINT64  mSystemMemoryEnd = FixedPcdGet64 (PcdSystemMemoryBase) +
                            FixedPcdGet64 (PcdSystemMemorySize) - 1;
 
+// BootShim tags the counter values around its payload copy with this
+#define BOOT_SHIM_TIMING_SIGNATURE  SIGNATURE_64 ('B', 'O', 'O', 'T', 'S', 'H', 'I', 'M')
+
 VOID EFIAPI ProcessLibraryConstructorList(VOID);
 
+// Log how long BootShim spent copying or decoding the FD into place
+STATIC
+VOID
+ReportBootShim(
+  IN UINT64 ShimStart,
+  IN UINT64 ShimEnd,
+  IN UINT64 ShimSignature
+  )
+{
+  if (ShimSignature != BOOT_SHIM_TIMING_SIGNATURE || ShimEnd < ShimStart) {
+    return;
+  }
+
+  DEBUG((
+      EFI_D_INFO, "BootShim: FD moved into place in %lu us\n",
+      DivU64x32 (GetTimeInNanoSecond (ShimEnd - ShimStart), 1000)));
+}
+
+// Log the size/speed tradeoff of the FVMAIN compression the build selected
+STATIC
+VOID
+ReportFirstFvDecompression(
+  IN UINT64 StartTicks
+  )
+{
+  UINT64                      ElapsedNs;
+  UINT64                      Length;
+  EFI_PEI_HOB_POINTERS        Hob;
+  EFI_FIRMWARE_VOLUME_HEADER *CompactFv;
+
+  ElapsedNs = GetTimeInNanoSecond (GetPerformanceCounter () - StartTicks);
+  CompactFv = (EFI_FIRMWARE_VOLUME_HEADER *)(UINTN)FixedPcdGet64 (PcdFdBaseAddress);
+
+  // DecompressFirstFv publishes the decompressed FV last
+  Length = 0;
+  for (Hob.Raw = GetHobList ();
+       (Hob.Raw = GetNextHob (EFI_HOB_TYPE_FV, Hob.Raw)) != NULL;
+       Hob.Raw = GET_NEXT_HOB (Hob)) {
+    Length = Hob.FirmwareVolume->Length;
+  }
+
+  DEBUG((
+      EFI_D_INFO, "DecompressFirstFv: 0x%lx byte FV to 0x%lx bytes in %lu us\n",
+      CompactFv->FvLength, Length, DivU64x32 (ElapsedNs, 1000)));
+}
+
 VOID
 PrePiMain(
   IN VOID *StackBase,
-  IN UINTN StackSize
+  IN UINTN StackSize,
+  IN UINT64 StartTimeStamp
   )
 {
 
   EFI_HOB_HANDOFF_INFO_TABLE *HobList;
   EFI_STATUS                  Status;
+  FIRMWARE_SEC_PERFORMANCE    Performance;
+  UINT64                      DecompressStart;
 
   UINTN MemoryBase     = 0;
   UINTN MemorySize     = 0;
@@ -75,12 +131,22 @@ PrePiMain(
 
   PrePeiSetHobList (HobList);
 
+  // Now, the HOB List has been initialized, we can register performance information
+  if (PerformanceMeasurementEnabled ()) {
+    // Time from reset to the first C code, reported as ResetEnd in the FPDT
+    Performance.ResetEnd = GetTimeInNanoSecond (StartTimeStamp);
+    BuildGuidDataHob (&gEfiFirmwarePerformanceGuid, &Performance, sizeof (Performance));
+  }
+  PERF_START (NULL, "PEI", NULL, StartTimeStamp);
+
   // Invalidate cache
   InvalidateDataCacheRange(
       (VOID *)(UINTN)PcdGet64(PcdFdBaseAddress), PcdGet32(PcdFdSize));
 
   // Initialize MMU
+  PERF_INMODULE_BEGIN ("MemoryPeim");
   Status = MemoryPeim(UefiMemoryBase, UefiMemorySize);
+  PERF_INMODULE_END ("MemoryPeim");
   ASSERT_EFI_ERROR (Status);
 
   // Add HOBs
@@ -94,19 +160,33 @@ PrePiMain(
 
   // Initialize Platform HOBs (CpuHob and FvHob)
   DEBUG((EFI_D_INFO, "PlatformPeim In \n"));
+  PERF_INMODULE_BEGIN ("PlatformPeim");
   Status = PlatformPeim();
+  PERF_INMODULE_END ("PlatformPeim");
   ASSERT_EFI_ERROR (Status);
 
-  // Now, the HOB List has been initialized, we can register performance information
-  // PERF_START (NULL, "PEI", NULL, StartTimeStamp);
-
   // SEC phase needs to run library constructors by hand.
   ProcessLibraryConstructorList();
 
-  // Assume the FV that contains the SEC (our code) also contains a compressed FV.
-  DEBUG((EFI_D_INFO, "DecompressFirstFv In \n"));
-  Status = DecompressFirstFv();
-  ASSERT_EFI_ERROR (Status);
+  // A warm reboot may have left the FV decompressed in the FV cache
+  PERF_INMODULE_BEGIN ("FvCacheRestore");
+  Status = FvCacheRestore();
+  PERF_INMODULE_END ("FvCacheRestore");
+  if (EFI_ERROR (Status)) {
+    // Assume the FV that contains the SEC (our code) also contains a compressed FV.
+    DEBUG((EFI_D_INFO, "DecompressFirstFv In \n"));
+    PERF_INMODULE_BEGIN ("DecompressFirstFv");
+    DecompressStart = GetPerformanceCounter ();
+    Status = DecompressFirstFv();
+    PERF_INMODULE_END ("DecompressFirstFv");
+    ASSERT_EFI_ERROR (Status);
+    ReportFirstFvDecompression (DecompressStart);
+
+    FvCacheSave();
+  }
+
+  // The secondary cores have to be off before DXE takes them over
+  PrePiMpPark();
 
   // Load the DXE Core and transfer control to it
   DEBUG((EFI_D_INFO, "LoadDxeCoreFromFv In \n"));
@@ -117,14 +197,28 @@ PrePiMain(
 VOID
 CEntryPoint(
   IN VOID *StackBase,
-  IN UINTN StackSize
+  IN UINTN StackSize,
+  IN UINT64 ShimStart,
+  IN UINT64 ShimEnd,
+  IN UINT64 ShimSignature
   )
 {
+  UINT64 StartTimeStamp;
+
+  // First C code of the boot; everything FPDT reports is measured from here
+  if (PerformanceMeasurementEnabled ()) {
+    StartTimeStamp = GetPerformanceCounter ();
+  } else {
+    StartTimeStamp = 0;
+  }
+
   // Do platform specific initialization here
   PlatformInitialize();
 
+  ReportBootShim(ShimStart, ShimEnd, ShimSignature);
+
   // Goto primary Main.
-  PrePiMain(StackBase, StackSize);
+  PrePiMain(StackBase, StackSize, StartTimeStamp);
 
   // DXE Core should always load and never return
   ASSERT(FALSE);
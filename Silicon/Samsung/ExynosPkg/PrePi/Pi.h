@@ -40,4 +40,16 @@ BuildMemoryTypeInformationHob (
   VOID
   );
 
+// FvCache.c: publish the FV a previous boot cached, or cache the one
+// DecompressFirstFv just published
+EFI_STATUS
+FvCacheRestore (
+  VOID
+  );
+
+VOID
+FvCacheSave (
+  VOID
+  );
+
 #endif /* _PREPI_H_ */
\ No newline at end of file
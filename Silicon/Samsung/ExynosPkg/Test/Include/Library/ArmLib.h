@@ -0,0 +1,32 @@
+/** @file
+  Host stand-in for the part of ArmPkg's ArmLib the ExynosPkg libraries under
+  host test call. ArmPkg's header only builds for ARM and AARCH64.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _HOST_ARM_LIB_H_
+#define _HOST_ARM_LIB_H_
+
+/**
+  Returns TRUE if interrupts are enabled.
+**/
+BOOLEAN
+EFIAPI
+ArmGetInterruptState(VOID);
+
+/**
+  Masks interrupts.
+**/
+VOID
+EFIAPI
+ArmDisableInterrupts(VOID);
+
+/**
+  Unmasks interrupts.
+**/
+VOID
+EFIAPI
+ArmEnableInterrupts(VOID);
+
+#endif
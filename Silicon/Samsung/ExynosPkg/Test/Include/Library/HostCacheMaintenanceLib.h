@@ -0,0 +1,38 @@
+/** @file
+  Lets host tests see the data cache maintenance the code under test asked
+  the host CacheMaintenanceLib for. Nothing is cleaned on the host; the calls
+  are only counted.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _HOST_CACHE_MAINTENANCE_LIB_H_
+#define _HOST_CACHE_MAINTENANCE_LIB_H_
+
+typedef struct {
+  // WriteBack[Invalidate]DataCacheRange calls and the bytes they covered
+  UINT64 RangeCalls;
+  UINT64 RangeBytes;
+  // Lowest address and end of the highest range cleaned, MAX_UINTN and 0
+  // while RangeCalls is 0
+  UINTN  Lowest;
+  UINTN  Highest;
+  // Calls that clean or invalidate the whole data cache
+  UINT64 WholeCacheCalls;
+} HOST_CACHE_MAINTENANCE_STATS;
+
+/**
+  Forget the calls made so far.
+**/
+VOID
+EFIAPI
+HostCacheMaintenanceReset(VOID);
+
+/**
+  Returns the calls made since the last reset.
+**/
+VOID
+EFIAPI
+HostCacheMaintenanceGetStats(OUT HOST_CACHE_MAINTENANCE_STATS *Stats);
+
+#endif
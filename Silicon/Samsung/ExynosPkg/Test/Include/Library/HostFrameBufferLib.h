@@ -0,0 +1,61 @@
+/** @file
+  The framebuffer of the ExynosPkg host tests, mapped where the code under
+  test expects it, and checks of what was drawn into it.
+
+  Golden images are arrays of strings, one per pixel row and one character
+  per pixel:
+
+    ' '  0x00000000 (cleared, no alpha)
+    '.'  FB_BGRA8888_BLACK
+    '#'  FB_BGRA8888_WHITE
+    'Y'  FB_BGRA8888_YELLOW    'C'  FB_BGRA8888_CYAN
+    'B'  FB_BGRA8888_BLUE      'S'  FB_BGRA8888_SILVER
+    'O'  FB_BGRA8888_ORANGE    'R'  FB_BGRA8888_RED
+    'G'  FB_BGRA8888_GREEN     '?'  anything else
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _HOST_FRAME_BUFFER_LIB_H_
+#define _HOST_FRAME_BUFFER_LIB_H_
+
+/**
+  Map a zero filled framebuffer of PcdMipiFrameBufferWidth *
+  PcdMipiFrameBufferHeight 32bpp pixels at PcdMipiFrameBufferAddress, with
+  room for the FbCon shared state behind it. Mapping it again only clears it.
+
+  @retval The framebuffer, or NULL if that address range is taken.
+**/
+UINT32 *
+EFIAPI
+HostFrameBufferMap(VOID);
+
+/**
+  Release the mapping made by HostFrameBufferMap.
+**/
+VOID
+EFIAPI
+HostFrameBufferUnmap(VOID);
+
+/**
+  Compare a rectangle of the framebuffer with a golden image of the same
+  size. On a mismatch the rectangle is printed as a golden image, so it can
+  be reviewed and pasted in when the change is intended.
+
+  @retval TRUE  Every pixel matches.
+**/
+BOOLEAN
+EFIAPI
+HostFrameBufferMatches(
+    IN CONST CHAR8 *Name, IN UINTN X, IN UINTN Y, IN UINTN Width,
+    IN UINTN Height, IN CONST CHAR8 *CONST *Golden);
+
+/**
+  CalculateCrc32 of the whole framebuffer, for checks of more pixels than a
+  golden image should hold.
+**/
+UINT32
+EFIAPI
+HostFrameBufferCrc32(VOID);
+
+#endif
@@ -0,0 +1,33 @@
+/** @file
+  Host ArmLib: the interrupt mask is a flag, so tests can check it is
+  restored.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/ArmLib.h>
+
+STATIC BOOLEAN mInterruptsEnabled = TRUE;
+
+BOOLEAN
+EFIAPI
+ArmGetInterruptState(VOID)
+{
+  return mInterruptsEnabled;
+}
+
+VOID
+EFIAPI
+ArmDisableInterrupts(VOID)
+{
+  mInterruptsEnabled = FALSE;
+}
+
+VOID
+EFIAPI
+ArmEnableInterrupts(VOID)
+{
+  mInterruptsEnabled = TRUE;
+}
@@ -0,0 +1,96 @@
+/** @file
+  Host CacheMaintenanceLib: cleans nothing, counts what it was asked to
+  clean (HostCacheMaintenanceLib).
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/HostCacheMaintenanceLib.h>
+
+STATIC HOST_CACHE_MAINTENANCE_STATS mStats = {0, 0, MAX_UINTN, 0, 0};
+
+STATIC
+VOID
+HostRecordRange(IN VOID *Address, IN UINTN Length)
+{
+  mStats.RangeCalls++;
+  mStats.RangeBytes += Length;
+  mStats.Lowest  = MIN(mStats.Lowest, (UINTN)Address);
+  mStats.Highest = MAX(mStats.Highest, (UINTN)Address + Length);
+}
+
+VOID
+EFIAPI
+HostCacheMaintenanceReset(VOID)
+{
+  ZeroMem(&mStats, sizeof(mStats));
+  mStats.Lowest = MAX_UINTN;
+}
+
+VOID
+EFIAPI
+HostCacheMaintenanceGetStats(OUT HOST_CACHE_MAINTENANCE_STATS *Stats)
+{
+  CopyMem(Stats, &mStats, sizeof(*Stats));
+}
+
+VOID
+EFIAPI
+InvalidateInstructionCache(VOID)
+{
+}
+
+VOID *
+EFIAPI
+InvalidateInstructionCacheRange(IN VOID *Address, IN UINTN Length)
+{
+  return Address;
+}
+
+VOID
+EFIAPI
+WriteBackInvalidateDataCache(VOID)
+{
+  mStats.WholeCacheCalls++;
+}
+
+VOID *
+EFIAPI
+WriteBackInvalidateDataCacheRange(IN VOID *Address, IN UINTN Length)
+{
+  HostRecordRange(Address, Length);
+  return Address;
+}
+
+VOID
+EFIAPI
+WriteBackDataCache(VOID)
+{
+  mStats.WholeCacheCalls++;
+}
+
+VOID *
+EFIAPI
+WriteBackDataCacheRange(IN VOID *Address, IN UINTN Length)
+{
+  HostRecordRange(Address, Length);
+  return Address;
+}
+
+VOID
+EFIAPI
+InvalidateDataCache(VOID)
+{
+  mStats.WholeCacheCalls++;
+}
+
+VOID *
+EFIAPI
+InvalidateDataCacheRange(IN VOID *Address, IN UINTN Length)
+{
+  return Address;
+}
@@ -0,0 +1,166 @@
+/** @file
+  The framebuffer of the ExynosPkg host tests, mapped at
+  PcdMipiFrameBufferAddress next to the FbCon state at PcdFbConStateBase, and
+  golden image checks.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <sys/mman.h>
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HostFrameBufferLib.h>
+#include <Library/PcdLib.h>
+
+#include <Resources/FbColor.h>
+
+#define HOST_FRAME_BUFFER_ADDRESS                                              \
+  ((UINT32 *)(UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress))
+#define HOST_FRAME_BUFFER_WIDTH  FixedPcdGet32(PcdMipiFrameBufferWidth)
+#define HOST_FRAME_BUFFER_HEIGHT FixedPcdGet32(PcdMipiFrameBufferHeight)
+#define HOST_FRAME_BUFFER_SIZE                                                 \
+  (HOST_FRAME_BUFFER_WIDTH * HOST_FRAME_BUFFER_HEIGHT * sizeof(UINT32))
+
+#define HOST_FBCON_STATE_ADDRESS                                               \
+  ((VOID *)(UINTN)FixedPcdGet64(PcdFbConStateBase))
+#define HOST_FBCON_STATE_SIZE FixedPcdGet32(PcdFbConStateSize)
+
+STATIC CONST struct {
+  UINT32 Color;
+  CHAR8  Char;
+} mGoldenPalette[] = {
+    {0, ' '},
+    {FB_BGRA8888_BLACK, '.'},
+    {FB_BGRA8888_WHITE, '#'},
+    {FB_BGRA8888_YELLOW, 'Y'},
+    {FB_BGRA8888_CYAN, 'C'},
+    {FB_BGRA8888_BLUE, 'B'},
+    {FB_BGRA8888_SILVER, 'S'},
+    {FB_BGRA8888_ORANGE, 'O'},
+    {FB_BGRA8888_RED, 'R'},
+    {FB_BGRA8888_GREEN, 'G'},
+};
+
+STATIC BOOLEAN mMapped;
+
+STATIC
+BOOLEAN
+HostMapFixed(IN VOID *Address, IN UINTN Size)
+{
+  VOID *Mapping;
+
+  Mapping = mmap(
+      Address, Size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if (Mapping == MAP_FAILED)
+    return FALSE;
+
+  // Kernels without MAP_FIXED_NOREPLACE take the address as a hint only
+  if (Mapping != Address) {
+    munmap(Mapping, Size);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+UINT32 *
+EFIAPI
+HostFrameBufferMap(VOID)
+{
+  // Both tests and the code under test only use 32bpp
+  ASSERT(FixedPcdGet32(PcdMipiFrameBufferPixelBpp) == 32);
+
+  if (!mMapped) {
+    if (!HostMapFixed(HOST_FRAME_BUFFER_ADDRESS, HOST_FRAME_BUFFER_SIZE))
+      return NULL;
+
+    if (!HostMapFixed(HOST_FBCON_STATE_ADDRESS, HOST_FBCON_STATE_SIZE)) {
+      munmap(HOST_FRAME_BUFFER_ADDRESS, HOST_FRAME_BUFFER_SIZE);
+      return NULL;
+    }
+
+    mMapped = TRUE;
+  }
+
+  ZeroMem(HOST_FRAME_BUFFER_ADDRESS, HOST_FRAME_BUFFER_SIZE);
+  ZeroMem(HOST_FBCON_STATE_ADDRESS, HOST_FBCON_STATE_SIZE);
+  return HOST_FRAME_BUFFER_ADDRESS;
+}
+
+VOID
+EFIAPI
+HostFrameBufferUnmap(VOID)
+{
+  if (!mMapped)
+    return;
+
+  munmap(HOST_FRAME_BUFFER_ADDRESS, HOST_FRAME_BUFFER_SIZE);
+  munmap(HOST_FBCON_STATE_ADDRESS, HOST_FBCON_STATE_SIZE);
+  mMapped = FALSE;
+}
+
+STATIC
+CHAR8
+HostGoldenChar(IN UINT32 Color)
+{
+  UINTN Index;
+
+  for (Index = 0; Index < ARRAY_SIZE(mGoldenPalette); Index++) {
+    if (mGoldenPalette[Index].Color == Color)
+      return mGoldenPalette[Index].Char;
+  }
+  return '?';
+}
+
+BOOLEAN
+EFIAPI
+HostFrameBufferMatches(
+    IN CONST CHAR8 *Name, IN UINTN X, IN UINTN Y, IN UINTN Width,
+    IN UINTN Height, IN CONST CHAR8 *CONST *Golden)
+{
+  CONST UINT32 *Line;
+  CHAR8         Row[HOST_FRAME_BUFFER_WIDTH + 1];
+  UINTN         Mismatches;
+  UINTN         Col;
+  UINTN         Index;
+
+  ASSERT(X + Width <= HOST_FRAME_BUFFER_WIDTH);
+  ASSERT(Y + Height <= HOST_FRAME_BUFFER_HEIGHT);
+
+  Mismatches = 0;
+  for (Index = 0; Index < Height; Index++) {
+    Line = HOST_FRAME_BUFFER_ADDRESS + (Y + Index) * HOST_FRAME_BUFFER_WIDTH + X;
+    for (Col = 0; Col < Width; Col++) {
+      if (Golden[Index][Col] != HostGoldenChar(Line[Col]))
+        Mismatches++;
+    }
+  }
+
+  if (Mismatches == 0)
+    return TRUE;
+
+  DEBUG(
+      (DEBUG_ERROR, "%a: %lu pixels differ from the golden image, got:\n",
+       Name, (UINT64)Mismatches));
+  for (Index = 0; Index < Height; Index++) {
+    Line = HOST_FRAME_BUFFER_ADDRESS + (Y + Index) * HOST_FRAME_BUFFER_WIDTH + X;
+    for (Col = 0; Col < Width; Col++)
+      Row[Col] = HostGoldenChar(Line[Col]);
+    Row[Width] = '\0';
+    DEBUG((DEBUG_ERROR, "    \"%a\",\n", Row));
+  }
+
+  return FALSE;
+}
+
+UINT32
+EFIAPI
+HostFrameBufferCrc32(VOID)
+{
+  return CalculateCrc32(HOST_FRAME_BUFFER_ADDRESS, HOST_FRAME_BUFFER_SIZE);
+}
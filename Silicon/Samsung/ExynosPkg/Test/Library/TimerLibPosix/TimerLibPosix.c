@@ -0,0 +1,68 @@
+/** @file
+  Host TimerLib on the POSIX monotonic clock; the performance counter counts
+  nanoseconds.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+
+#include <Library/TimerLib.h>
+
+STATIC
+UINT64
+HostNanoseconds(VOID)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+UINTN
+EFIAPI
+NanoSecondDelay(IN UINTN NanoSeconds)
+{
+  struct timespec Delay;
+
+  Delay.tv_sec  = NanoSeconds / 1000000000;
+  Delay.tv_nsec = NanoSeconds % 1000000000;
+  nanosleep(&Delay, NULL);
+  return NanoSeconds;
+}
+
+UINTN
+EFIAPI
+MicroSecondDelay(IN UINTN MicroSeconds)
+{
+  NanoSecondDelay(MicroSeconds * 1000);
+  return MicroSeconds;
+}
+
+UINT64
+EFIAPI
+GetPerformanceCounter(VOID)
+{
+  return HostNanoseconds();
+}
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties(
+    OUT UINT64 *StartValue OPTIONAL, OUT UINT64 *EndValue OPTIONAL)
+{
+  if (StartValue != NULL)
+    *StartValue = 0;
+  if (EndValue != NULL)
+    *EndValue = MAX_UINT64;
+  return 1000000000;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond(IN UINT64 Ticks)
+{
+  return Ticks;
+}
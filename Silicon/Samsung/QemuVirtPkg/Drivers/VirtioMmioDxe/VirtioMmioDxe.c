@@ -0,0 +1,91 @@
+#include <PiDxe.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/IoLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/VirtioMmioDeviceLib.h>
+
+#include <Guid/VirtioMmioTransport.h>
+#include <Protocol/DevicePath.h>
+
+// QEMU virt lays out its virtio-mmio transports at fixed addresses
+#define VIRTIO_MMIO_BASE        0x0a000000
+#define VIRTIO_MMIO_STRIDE      0x200
+#define VIRTIO_MMIO_COUNT       32
+#define VIRTIO_MMIO_MAGIC       0x000
+#define VIRTIO_MMIO_DEVICE_ID   0x008
+
+#pragma pack(1)
+typedef struct {
+  VENDOR_DEVICE_PATH       Vendor;
+  UINT64                   PhysBase;
+  EFI_DEVICE_PATH_PROTOCOL End;
+} VIRTIO_TRANSPORT_DEVICE_PATH;
+#pragma pack()
+
+STATIC
+EFI_STATUS
+VirtioMmioInstallTransport(UINTN Base)
+{
+  VIRTIO_TRANSPORT_DEVICE_PATH *DevicePath;
+  EFI_HANDLE                    Handle = NULL;
+  EFI_STATUS                    Status;
+
+  Status = gBS->AllocatePool(
+      EfiBootServicesData, sizeof(*DevicePath), (VOID **)&DevicePath);
+  if (EFI_ERROR(Status))
+    return Status;
+
+  DevicePath->Vendor.Header.Type    = HARDWARE_DEVICE_PATH;
+  DevicePath->Vendor.Header.SubType = HW_VENDOR_DP;
+  SetDevicePathNodeLength(
+      &DevicePath->Vendor, sizeof(DevicePath->Vendor) + sizeof(UINT64));
+  CopyGuid(&DevicePath->Vendor.Guid, &gVirtioMmioTransportGuid);
+  DevicePath->PhysBase = Base;
+  SetDevicePathEndNode(&DevicePath->End);
+
+  Status = gBS->InstallProtocolInterface(
+      &Handle, &gEfiDevicePathProtocolGuid, EFI_NATIVE_INTERFACE, DevicePath);
+  if (EFI_ERROR(Status)) {
+    gBS->FreePool(DevicePath);
+    return Status;
+  }
+
+  Status = VirtioMmioInstallDevice(Base, Handle);
+  if (EFI_ERROR(Status)) {
+    gBS->UninstallProtocolInterface(
+        Handle, &gEfiDevicePathProtocolGuid, DevicePath);
+    gBS->FreePool(DevicePath);
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+EFIAPI
+VirtioMmioDxeInitialize(
+    IN EFI_HANDLE ImageHandle, IN EFI_SYSTEM_TABLE *SystemTable)
+{
+  UINTN      Index;
+  UINTN      Base;
+  EFI_STATUS Status;
+
+  for (Index = 0; Index < VIRTIO_MMIO_COUNT; Index++) {
+    Base = VIRTIO_MMIO_BASE + Index * VIRTIO_MMIO_STRIDE;
+
+    // Unused slots still answer with the magic but report device ID 0
+    if (MmioRead32(Base + VIRTIO_MMIO_MAGIC) != SIGNATURE_32('v', 'i', 'r', 't') ||
+        MmioRead32(Base + VIRTIO_MMIO_DEVICE_ID) == 0)
+      continue;
+
+    Status = VirtioMmioInstallTransport(Base);
+    if (EFI_ERROR(Status))
+      DEBUG(
+          (EFI_D_ERROR, "VirtioMmioDxe: transport at 0x%lx: %r\n", (UINT64)Base,
+           Status));
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include <Library/BaseLib.h>
+#include <Library/PlatformMemoryMapLib.h>
+
+static ARM_MEMORY_REGION_DESCRIPTOR_EX gDeviceMemoryDescriptorEx[] = {
+/*                                                    EFI_RESOURCE_ EFI_RESOURCE_ATTRIBUTE_ EFI_MEMORY_TYPE ARM_REGION_ATTRIBUTE_
+     MemLabel(32 Char.),  MemBase,    MemSize, BuildHob, ResourceType, ResourceAttribute, MemoryType, CacheAttributes
+--------------------- Register ---------------------*/
+    // QEMU virt: flash, GIC, PL011, RTC, fw_cfg, PL061, virtio-mmio, PCIe
+    {"Periphs",           0x00000000, 0x40000000,  AddMem, MEM_RES, UNCACHEABLE,  RtCode,   NS_DEVICE},
+
+//--------------------- DDR --------------------- */
+// Run with -m 4G; the layout mirrors the Exynos boards with RAM at 0x40000000
+
+    {"HLOS 0",            0x40000000, 0x00C00000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv, WRITE_BACK_XN},
+    {"UEFI Stack",        0x40C00000, 0x00040000, AddMem, SYS_MEM, SYS_MEM_CAP,  BsData, WRITE_BACK},
+    {"CPU Vectors",       0x40C40000, 0x00010000, AddMem, SYS_MEM, SYS_MEM_CAP,  BsCode, WRITE_BACK},
+    {"HLOS 0 Split",      0x40C50000, 0x0F3B0000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv, WRITE_BACK_XN},
+    {"UEFI FD",           0x50000000, 0x00700000, AddMem, SYS_MEM, SYS_MEM_CAP, BsCode, WRITE_BACK},
+    {"Persistent Log",    0x50700000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
+    {"FV Cache",          0x50800000, 0x01000000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"FbCon State",       0x51800000, 0x00100000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_BACK_XN},
+    {"HLOS 1",            0x51900000, 0x2D700000, AddMem, SYS_MEM, SYS_MEM_CAP, Conv,   WRITE_BACK},
+    {"Display Reserved",  0x7F000000, 0x01000000, AddMem, MEM_RES, SYS_MEM_CAP, Reserv, WRITE_THROUGH_XN},
+    {"HLOS 2",            0x80000000, 0xC0000000, AddMem, SYS_MEM, SYS_MEM_CAP,  Conv,   WRITE_BACK},
+
+
+//------------------- Terminator for MMU ---------------------
+{"Terminator", 0, 0, 0, 0, 0, 0, 0}};
+
+ARM_MEMORY_REGION_DESCRIPTOR_EX *GetPlatformMemoryMap()
+{
+  return gDeviceMemoryDescriptorEx;
+}
+
+// MPIDR affinity of each core, in the order the kernel numbers them
+static UINT64 gCoreMap[] = {
+    // -smp 8, fewer CPUs are left out by PsciMpServicesDxe
+    0x000, 0x001, 0x002, 0x003, 0x004, 0x005, 0x006, 0x007,
+};
+
+UINT64 *GetPlatformCoreMap(UINTN *CoreCount)
+{
+  *CoreCount = ARRAY_SIZE(gCoreMap);
+  return gCoreMap;
+}
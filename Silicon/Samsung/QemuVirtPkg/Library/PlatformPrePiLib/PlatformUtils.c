@@ -0,0 +1,163 @@
+#include <Library/PcdLib.h>
+#include <Library/ArmLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/HobLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/PrintLib.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryMapHelperLib.h>
+#include <Library/FrameBufferSerialPortLib.h>
+#include <Library/PlatformPrePiLib.h>
+#include <Library/PrePiMpLib.h>
+
+#include "PlatformUtils.h"
+
+
+VOID InitializeSharedUartBuffers(VOID)
+{
+  PFBCON_SHARED_STATE pFbConState = FBCON_SHARED_STATE_ADDRESS;
+
+  // Zero every field, so counters added to the header later start clean too
+  ZeroMem(pFbConState, sizeof(*pFbConState));
+}
+
+VOID UartInit(VOID)
+{
+  SerialPortInitialize();
+
+  InitializeSharedUartBuffers();
+
+  // Start this boot's section of the persistent RAM log
+  PersistentLogInitialize();
+
+  DEBUG((EFI_D_INFO, "\nRenegade Project edk2-exynos (AArch64)\n"));
+  DEBUG(
+      (EFI_D_INFO, "Firmware version %s built %a %a\n\n",
+       (CHAR16 *)PcdGetPtr(PcdFirmwareVersionString), __TIME__, __DATE__));
+}
+// QEMU virt fw_cfg, used to point ramfb at the RAM framebuffer
+#define FW_CFG_BASE            0x09020000
+#define FW_CFG_DATA            (FW_CFG_BASE + 0x00)
+#define FW_CFG_SELECTOR        (FW_CFG_BASE + 0x08)
+#define FW_CFG_DMA             (FW_CFG_BASE + 0x10)
+#define FW_CFG_SIGNATURE       0x0000
+#define FW_CFG_FILE_DIR        0x0019
+#define FW_CFG_DMA_CTL_ERROR   BIT0
+#define FW_CFG_DMA_CTL_SELECT  BIT3
+#define FW_CFG_DMA_CTL_WRITE   BIT4
+
+#pragma pack(1)
+typedef struct {
+  UINT32 Control;
+  UINT32 Length;
+  UINT64 Address;
+} FW_CFG_DMA_ACCESS;
+
+typedef struct {
+  UINT64 Address;
+  UINT32 FourCC;
+  UINT32 Flags;
+  UINT32 Width;
+  UINT32 Height;
+  UINT32 Stride;
+} RAMFB_CONFIG;
+#pragma pack()
+
+STATIC
+VOID
+FwCfgSelect(UINT16 Item)
+{
+  MmioWrite16(FW_CFG_SELECTOR, SwapBytes16(Item));
+}
+
+STATIC
+VOID
+FwCfgRead(VOID *Buffer, UINTN Size)
+{
+  UINT8 *Bytes = Buffer;
+
+  while (Size-- > 0)
+    *Bytes++ = MmioRead8(FW_CFG_DATA);
+}
+
+STATIC
+UINT16
+FwCfgFindFile(CONST CHAR8 *Name)
+{
+  UINT32 Count;
+  UINT32 Size;
+  UINT16 Select;
+  UINT16 Reserved;
+  CHAR8  FileName[56];
+
+  FwCfgSelect(FW_CFG_SIGNATURE);
+  FwCfgRead(&Count, sizeof(Count));
+  if (Count != SIGNATURE_32('Q', 'E', 'M', 'U'))
+    return 0;
+
+  FwCfgSelect(FW_CFG_FILE_DIR);
+  FwCfgRead(&Count, sizeof(Count));
+
+  for (Count = SwapBytes32(Count); Count > 0; Count--) {
+    FwCfgRead(&Size, sizeof(Size));
+    FwCfgRead(&Select, sizeof(Select));
+    FwCfgRead(&Reserved, sizeof(Reserved));
+    FwCfgRead(FileName, sizeof(FileName));
+
+    if (AsciiStrnCmp(FileName, Name, sizeof(FileName)) == 0)
+      return SwapBytes16(Select);
+  }
+
+  return 0;
+}
+
+// Point ramfb at the fixed framebuffer so FrameBufferSerialPortLib and
+// SimpleFbDxe draw to a visible surface, exactly as on the panel
+STATIC
+VOID
+RamFbInitialize(VOID)
+{
+  volatile FW_CFG_DMA_ACCESS Access;
+  RAMFB_CONFIG               Config;
+  UINT16                     Select;
+
+  Select = FwCfgFindFile("etc/ramfb");
+  if (Select == 0)
+    return;
+
+  Config.Address = SwapBytes64(FixedPcdGet32(PcdMipiFrameBufferAddress));
+  Config.FourCC  = SwapBytes32(SIGNATURE_32('X', 'R', '2', '4'));
+  Config.Flags   = 0;
+  Config.Width   = SwapBytes32(FixedPcdGet32(PcdMipiFrameBufferWidth));
+  Config.Height  = SwapBytes32(FixedPcdGet32(PcdMipiFrameBufferHeight));
+  Config.Stride  = SwapBytes32(
+      FixedPcdGet32(PcdMipiFrameBufferWidth) *
+      FixedPcdGet32(PcdMipiFrameBufferPixelBpp) / 8);
+
+  Access.Control = SwapBytes32(
+      ((UINT32)Select << 16) | FW_CFG_DMA_CTL_SELECT | FW_CFG_DMA_CTL_WRITE);
+  Access.Length  = SwapBytes32(sizeof(Config));
+  Access.Address = SwapBytes64((UINTN)&Config);
+
+  MmioWrite64(FW_CFG_DMA, SwapBytes64((UINTN)&Access));
+
+  // Completes synchronously; Control is cleared, or left with the error bit
+  while ((SwapBytes32(Access.Control) & ~FW_CFG_DMA_CTL_ERROR) != 0)
+    ;
+}
+
+VOID PlatformInitialize(VOID)
+{
+  // Clear the framebuffer on all cores like the devices do, which also gives
+  // tools/QemuSmpTiming a PrePiMp job to time
+  PrePiMpZeroMem(
+      (VOID *)(UINTN)FixedPcdGet32(PcdMipiFrameBufferAddress),
+      FixedPcdGet32(PcdMipiFrameBufferWidth) *
+          FixedPcdGet32(PcdMipiFrameBufferHeight) *
+          FixedPcdGet32(PcdMipiFrameBufferPixelBpp) / 8);
+  RamFbInitialize();
+  UartInit();
+}
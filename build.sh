@@ -14,6 +14,13 @@ function _help(){
 	echo "	--uart, -u:              compile with UART support, print debug messages to uart debug port."
 	echo " 	--skip-rootfs-gen:       skip generating SimpleInit rootfs to speed up building."
 	echo " 	--no-exception-disp:     do not display exception information in DEBUG builds."
+	echo " 	--headless:              do not draw debug output, only keep it in the persistent RAM log."
+	echo " 	--shadow-fb:             render GOP into a cached shadow buffer and present damaged areas."
+	echo " 	--fv-cache:              reuse the FVMAIN a previous boot decompressed after a warm reset."
+	echo " 	--perf:                  record boot performance and publish an FPDT, view with 'dp' in the shell."
+	echo " 	--fv-compression ALGO:   compress FVMAIN with 'lzma' or 'lz4', default is the device's FV_COMPRESSION or 'lzma'."
+	echo " 	--lz4-payload:           LZ4-compress the FD in boot.img, BootShim decodes it into place."
+	echo " 	--host-tests:            build and run the host-based unit tests instead of a device image."
 	echo "	--acpi, -A:              compile DSDT using MS asl with wine."
 	echo "	--clean, -C:             clean workspace and output."
 	echo "	--distclean, -D:         clean up all files that are not in repo."
@@ -54,6 +61,7 @@ function _build(){
 
 	SPLIT_DSDT=false
 	EXT=""
+	typeset -u FV_COMPRESSION=LZMA
 
 	if [ -f "configs/devices/${DEVICE}.conf" ]
 	then source "configs/devices/${DEVICE}.conf"
@@ -66,6 +74,11 @@ function _build(){
 	fi
 	# for overriding config
 	source "configs/devices/${DEVICE}.conf"
+	[ -n "${FV_COMPRESSION_OPT}" ]&&FV_COMPRESSION="${FV_COMPRESSION_OPT}"
+	case "${FV_COMPRESSION}" in
+		LZMA|LZ4);;
+		*) _error "Unknown FV compression ${FV_COMPRESSION}";;
+	esac
 
 	if "${GEN_INSTALLER_ZIP}"
 	then
@@ -115,12 +128,6 @@ function _build(){
 		*) _MODE=DEBUG;;
 	esac
 
-	echo "Building BootShim"
-	pushd "${ROOTDIR}/tools/BootShim"
-	rm -f BootShim.bin BootShim.elf BootShim.Dualboot.bin BootShim.Dualboot.elf
-	make UEFI_BASE=${FD_BASE} UEFI_SIZE=${FD_SIZE}
-	popd
-
 	_call_hook platform_pre_build||return "$?"
 	mkdir -p "${ROOTDIR}/Common/edk2/Conf"
 	cp "${ROOTDIR}/tools/"{build_rule.txt,tools_def.txt} "${ROOTDIR}/Common/edk2/Conf/"
@@ -135,9 +142,41 @@ function _build(){
 		-D USE_UART="${USE_UART}" \
 		-D FIX_CLANG="${FIX_CLANG}" \
 		-D NO_EXCEPTION_DISPLAY="${NO_EXCEPTION_DISPLAY}" \
+		-D HEADLESS_CONSOLE="${HEADLESS_CONSOLE}" \
+		-D SHADOW_FRAMEBUFFER="${SHADOW_FRAMEBUFFER}" \
+		-D FV_CACHE="${FV_CACHE}" \
+		-D PERF_TRACE="${PERF_TRACE}" \
+		-D FV_COMPRESSION="${FV_COMPRESSION}" \
 		-D FD_BASE="${FD_BASE}" -D FD_SIZE="${FD_SIZE}" \
 		-D ENABLE_LINUX_UTILS="${ENABLE_LINUX_UTILS}" \
 		||return "$?"
+	local _FV="${WORKSPACE}/Build/${DEVICE}/${_MODE}_${TOOLCHAIN}/FV"
+	echo "FVMAIN: $(stat -c %s "${_FV}/FVMAIN.Fv") bytes, FVEXT (deferred): $(stat -c %s "${_FV}/FVEXT.Fv") bytes, ${FV_COMPRESSION} FVMAIN_COMPACT: $(stat -c %s "${_FV}/FVMAIN_COMPACT.Fv") bytes"
+
+	# PrePi only reuses a cached FVMAIN that matches this digest
+	"${ROOTDIR}/tools/FvCacheDigest" "${_FV}/FVMAIN.Fv" "${_FV}/${SOC_PLATFORM}_UEFI.fd"||return "$?"
+
+	# The shim copies only the used part of the FD, so it is built last, and
+	# boot.img carries only that part, LZ4-compressed with --lz4-payload
+	local PAYLOAD_SIZE PACKED_SIZE=0
+	PAYLOAD_SIZE="$("${ROOTDIR}/tools/FdPayloadSize" "${_FV}/${SOC_PLATFORM}_UEFI.fd")"||return "$?"
+	head -c "$((PAYLOAD_SIZE))" "${_FV}/${SOC_PLATFORM}_UEFI.fd" > "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload"||return "$?"
+	if [ "${LZ4_PAYLOAD}" == 1 ]
+	then
+		"${ROOTDIR}/tools/Lz4Compress" -e --in-place "${FD_SIZE}" \
+			-o "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload.lz4" "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload" \
+			||return "$?"
+		mv "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload.lz4" "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload"
+		PACKED_SIZE="$(stat -c %s "${_FV}/${SOC_PLATFORM}_UEFI.fd-payload")"
+		echo "Building BootShim, payload ${PAYLOAD_SIZE} of ${FD_SIZE} bytes, LZ4 to ${PACKED_SIZE} bytes"
+	else
+		echo "Building BootShim, payload ${PAYLOAD_SIZE} of ${FD_SIZE} bytes"
+	fi
+	pushd "${ROOTDIR}/tools/BootShim"
+	rm -f BootShim.bin BootShim.elf BootShim.Dualboot.bin BootShim.Dualboot.elf
+	make UEFI_BASE=${FD_BASE} UEFI_SIZE=${FD_SIZE} PAYLOAD_SIZE=${PAYLOAD_SIZE} LZ4_PAYLOAD=${LZ4_PAYLOAD} PACKED_SIZE=${PACKED_SIZE}
+	popd
+
 	_call_hook platform_build_kernel||return "$?"
 	_call_hook platform_build_bootimg||return "$?"
 	echo "Build done: ${OUTDIR}/boot-${DEVICE}${EXT}.img"
@@ -157,6 +196,29 @@ function _build(){
 	set +x
 }
 
+function _host_tests(){
+	source "${_EDK2}/edksetup.sh"
+	[ -d "${WORKSPACE}" ]||mkdir "${WORKSPACE}"
+	set -x
+	make -C "${_EDK2}/BaseTools"||exit "$?"
+	mkdir -p "${ROOTDIR}/Common/edk2/Conf"
+	cp "${ROOTDIR}/tools/"{build_rule.txt,tools_def.txt} "${ROOTDIR}/Common/edk2/Conf/"
+	local DSC TEST E=0
+	for DSC in Silicon/Samsung/ExynosPkg/Test/*HostTest.dsc Platform/RenegadePkg/Test/*HostTest.dsc
+	do
+		[ -f "${DSC}" ]||continue
+		build -s -a X64 -t GCC5 -b NOOPT -p "${ROOTDIR}/${DSC}"||return "$?"
+	done
+	set +x
+	for TEST in "${WORKSPACE}/Build/"*/HostTest/NOOPT_GCC5/X64/*HostTest
+	do
+		[ -x "${TEST}" ]||continue
+		echo "Running ${TEST##*/}"
+		"${TEST}"||E="$?"
+	done
+	return "${E}"
+}
+
 function _clean(){ rm --one-file-system --recursive --force "${WORKSPACE}"./workspace "${OUTDIR}"/boot-*.img "${OUTDIR}"/uefi-installer-*.zip "${OUTDIR}"/uefi-*.img*; }
 
 function _distclean(){ if [ -d .git ];then git clean -xdf;else _clean;fi; }
@@ -176,12 +238,19 @@ export FIX_CLANG=0
 SOC_VENDOR=Qualcomm
 USE_UART=0
 NO_EXCEPTION_DISPLAY=0
+HEADLESS_CONSOLE=0
+SHADOW_FRAMEBUFFER=0
+FV_CACHE=0
+PERF_TRACE=0
+HOST_TESTS=false
+FV_COMPRESSION_OPT=""
+LZ4_PAYLOAD=0
 export ROOTDIR OUTDIR SOC_VENDOR
 export GEN_ACPI=false
 export GEN_ROOTFS=true
 export GEN_INSTALLER_ZIP=false
 export FASTBOOT=false
-OPTS="$(getopt -o t:d:hfabczACDO:r:u -l toolchain:,device:,help,fixclang,all,boot,chinese,acpi,skip-rootfs-gen,no-exception-disp,installer-zip,uart,clean,distclean,outputdir:,release: -n 'build.sh' -- "$@")"||exit 1
+OPTS="$(getopt -o t:d:hfabczACDO:r:u -l toolchain:,device:,help,fixclang,all,boot,chinese,acpi,skip-rootfs-gen,no-exception-disp,headless,shadow-fb,fv-cache,perf,host-tests,fv-compression:,lz4-payload,installer-zip,uart,clean,distclean,outputdir:,release: -n 'build.sh' -- "$@")"||exit 1
 eval set -- "${OPTS}"
 while true
 do	case "${1}" in
@@ -195,6 +264,13 @@ do	case "${1}" in
 		-O|--outputdir) OUTDIR="${2}";shift 2;;
 		--skip-rootfs-gen) GEN_ROOTFS=false;shift;;
 		--no-exception-disp) NO_EXCEPTION_DISPLAY=1;shift;;
+		--headless) HEADLESS_CONSOLE=1;shift;;
+		--shadow-fb) SHADOW_FRAMEBUFFER=1;shift;;
+		--fv-cache) FV_CACHE=1;shift;;
+		--perf) PERF_TRACE=1;shift;;
+		--host-tests) HOST_TESTS=true;shift;;
+		--fv-compression) FV_COMPRESSION_OPT="${2}";shift 2;;
+		--lz4-payload) LZ4_PAYLOAD=1;shift;;
 		-r|--release) MODE="${2}";shift 2;;
 		-t|--toolchain) TOOLCHAIN="${2}";shift 2;;
 		-u|--uart) USE_UART=1;shift;;
@@ -207,7 +283,7 @@ do	case "${1}" in
 done
 if "${DISTCLEAN}";then _distclean;exit "$?";fi
 if "${CLEAN}";then _clean;exit "$?";fi
-[ -z "${DEVICE}" ]&&_help 1
+"${HOST_TESTS}"||[ -n "${DEVICE}" ]||_help 1
 if ! [ -f Common/edk2/edksetup.sh ] && ! [ -f ../edk2/edksetup.sh ]
 then
 	set -e
@@ -280,16 +356,23 @@ done
 [ -n "${_EDK2}" ]||_error "EDK2 not found, please see README.md"
 [ -n "${_EDK2_PLATFORMS}" ]||_error "EDK2 Platforms not found, please see README.md"
 [ -n "${_SIMPLE_INIT}" ]||_error "SimpleInit not found, please see README.md"
-[ -f "configs/devices/${DEVICE}.conf" ]||_error "Device configuration not found"
+"${HOST_TESTS}"||[ -f "configs/devices/${DEVICE}.conf" ]||_error "Device configuration not found"
 echo "EDK2 Path: ${_EDK2}"
 echo "EDK2_PLATFORMS Path: ${_EDK2_PLATFORMS}"
 export CROSS_COMPILE="${CROSS_COMPILE:-aarch64-linux-gnu-}"
 export GCC5_AARCH64_PREFIX="${CROSS_COMPILE}"
 export CLANG38_AARCH64_PREFIX="${CROSS_COMPILE}"
+# GUIDED section tools that are not part of BaseTools, see tools_def.txt
+export PATH="${ROOTDIR}/tools:${PATH}"
 export PACKAGES_PATH="$_EDK2:$_EDK2_PLATFORMS:$_SIMPLE_INIT:$PWD:$PWD/GPLDrivers"
 export WORKSPACE="${OUTDIR}/workspace"
 GITCOMMIT="$(git describe --tags --always)"||GITCOMMIT="unknown"
 export GITCOMMIT
+if "${HOST_TESTS}"
+then
+	_host_tests
+	exit "$?"
+fi
 echo > ramdisk
 set -e
 mkdir -p "${_SIMPLE_INIT}/build" "${_SIMPLE_INIT}/root/usr/share/locale"